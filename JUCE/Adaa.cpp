@@ -0,0 +1,100 @@
+/*
+	Antiderivative anti-aliasing for the compiled remapping chain. Instead of
+	sampling the curve at each input, ADAA outputs the curve's average over
+	the segment between consecutive inputs, taken from the antiderivatives in
+	the TransferTable. This suppresses most of the aliasing that the remapper
+	would otherwise produce, at the cost of a slight high-frequency rolloff
+	and a delay of half a sample (first order) or one sample (second order).
+
+	When consecutive inputs are too close together for the difference of
+	antiderivatives to be meaningful, the curve is evaluated directly at the
+	midpoint, which is what the average tends to. Inputs outside the table
+	fall back to plain lookup().
+*/
+#pragma once
+#include "TransferTable.cpp"
+
+enum {
+	ANTIALIASING_OFF,
+	ANTIALIASING_ADAA1,
+	ANTIALIASING_ADAA2
+};
+
+// Below this step in the input, a divided difference is replaced by a midpoint value
+const double ADAA_EPSILON = 1e-5;
+
+/*
+	Whole samples, at the rate the remapper runs, by which an order delays its
+	output. The oversampler counts these in its latency and the dry path is
+	delayed to match. First order's half sample cannot be matched by a
+	whole-sample delay and is left in: blended with the dry signal, it dips
+	the response by up to 3 dB at the remapper's Nyquist frequency, which
+	oversampling moves above the audible band.
+*/
+inline int adaa_delay(int antialiasing) {
+	return antialiasing == ANTIALIASING_ADAA2 ? 1 : 0;
+}
+
+// Per-channel history
+struct AdaaState {
+	float x1 = 0;		// previous input
+	float x2 = 0;		// input before that
+	double d1 = 0;		// second order: divided difference of antiderivative2 over [x2, x1]
+	bool d1_valid = false;
+};
+
+// Average of lookup() over [a, b]
+inline double adaa_mean1(const TransferTable& table, float a, float b) {
+	double dx = (double)a - b;
+	if (abs(dx) < ADAA_EPSILON) {
+		return table.lookup(0.5f * (a + b));
+	}
+	return (table.antiderivative1(a) - table.antiderivative1(b)) / dx;
+}
+
+// Divided difference of antiderivative2 over [a, b]
+inline double adaa_mean2(const TransferTable& table, float a, float b) {
+	double dx = (double)a - b;
+	if (abs(dx) < ADAA_EPSILON) {
+		return table.antiderivative1(0.5f * (a + b));
+	}
+	return (table.antiderivative2(a) - table.antiderivative2(b)) / dx;
+}
+
+inline float adaa1(const TransferTable& table, AdaaState& state, float x) {
+	float x1 = state.x1;
+	state.x2 = x1;
+	state.x1 = x;
+	state.d1_valid = false;
+	if (!TransferTable::inRange(x) || !TransferTable::inRange(x1)) {
+		return table.lookup(x);
+	}
+	return (float)adaa_mean1(table, x, x1);
+}
+
+inline float adaa2(const TransferTable& table, AdaaState& state, float x) {
+	float x1 = state.x1;
+	float x2 = state.x2;
+	state.x2 = x1;
+	state.x1 = x;
+	if (!TransferTable::inRange(x) || !TransferTable::inRange(x1) || !TransferTable::inRange(x2)) {
+		state.d1_valid = false;
+		return table.lookup(x);
+	}
+	double d0 = adaa_mean2(table, x, x1);
+	double d1 = state.d1_valid ? state.d1 : adaa_mean2(table, x1, x2);
+	state.d1 = d0;
+	state.d1_valid = true;
+
+	double dx = (double)x - x2;
+	if (abs(dx) >= ADAA_EPSILON) {
+		return (float)(2 * (d0 - d1) / dx);
+	}
+	// x and x2 coincide, so average over [x1, the midpoint of x and x2] instead
+	float mid = 0.5f * (x + x2);
+	double dmid = (double)mid - x1;
+	if (abs(dmid) < ADAA_EPSILON) {
+		return table.lookup(0.5f * (mid + x1));
+	}
+	return (float)(2 / dmid * (table.antiderivative1(mid) + (table.antiderivative2(x1) - table.antiderivative2(mid)) / dmid));
+}
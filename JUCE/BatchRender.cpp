@@ -0,0 +1,260 @@
+/*
+	Headless batch rendering. Streams audio files through the processor
+	with a preset applied, and writes each result under the same name in
+	the output directory:
+
+		GaloisRender --preset "Bad Radio" --out rendered drums.wav bass.aif
+
+	--preset takes the name of a factory preset, a preset file such as
+	presets/preset_BadRadio.xml, or a state file saved by the plugin.
+	Files are shared out between worker threads, each with a processor of
+	its own that is prepared afresh for every file. Each file goes through
+	processBlock() in blocks of --block samples, which is exactly what a
+	host using that block size would do, so the output is bit-identical
+	to the plugin's. --tail carries on for the processor's tail and
+	latency once the input has run out. --stats turns on the processor's
+	instrumentation and prints where each file's time went.
+
+	This is the GaloisRender target in CMakeLists.txt, and its only source
+	of its own. It is built with PluginProcessor.cpp, PluginEditor.cpp,
+	galois_dsp and the binary data, and with JucePlugin_Name defined, as
+	there is no plugin wrapper to define it.
+*/
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct RenderOptions {
+    juce::String preset;
+    juce::File output_directory;
+    int block_size = 512;
+    int num_threads = 0;
+    bool render_tail = false;
+    bool print_stats = false;
+    juce::Array<juce::File> files;
+};
+
+static void printUsage() {
+    std::cerr << "usage: GaloisRender --preset <name or file> --out <directory>" << std::endl
+              << "                    [--block <samples>] [--threads <count>] [--tail] [--stats] <files>..." << std::endl;
+}
+
+static bool parseArguments(int argc, char* argv[], RenderOptions& options) {
+    juce::File cwd = juce::File::getCurrentWorkingDirectory();
+    for (int i = 1; i < argc; ++i) {
+        juce::String arg(argv[i]);
+        bool has_value = i + 1 < argc;
+        if (arg == "--preset" && has_value) {
+            options.preset = argv[++i];
+        }
+        else if (arg == "--out" && has_value) {
+            options.output_directory = cwd.getChildFile(argv[++i]);
+        }
+        else if (arg == "--block" && has_value) {
+            options.block_size = juce::String(argv[++i]).getIntValue();
+        }
+        else if (arg == "--threads" && has_value) {
+            options.num_threads = juce::String(argv[++i]).getIntValue();
+        }
+        else if (arg == "--tail") {
+            options.render_tail = true;
+        }
+        else if (arg == "--stats") {
+            options.print_stats = true;
+        }
+        else if (arg.startsWith("--")) {
+            std::cerr << "unknown option " << arg << std::endl;
+            return false;
+        }
+        else {
+            options.files.add(cwd.getChildFile(arg));
+        }
+    }
+    if (options.preset.isEmpty() || options.output_directory == juce::File() || options.files.isEmpty() || options.block_size < 1) {
+        return false;
+    }
+    if (options.num_threads < 1) {
+        options.num_threads = juce::SystemStats::getNumCpus();
+    }
+    options.num_threads = juce::jmin(options.num_threads, options.files.size());
+    return true;
+}
+
+// The contents of a preset or state file, or nothing if preset is not a file
+static juce::MemoryBlock loadStateFile(const juce::String& preset) {
+    juce::MemoryBlock data;
+    juce::File file = juce::File::getCurrentWorkingDirectory().getChildFile(preset);
+    if (file.existsAsFile()) {
+        file.loadFileAsData(data);
+    }
+    return data;
+}
+
+// Applies a preset file or saved state, or failing that the factory preset of that name
+static bool applyPreset(Proto_galoisAudioProcessor& processor, const juce::String& preset, const juce::MemoryBlock& state) {
+    if (state.getSize() > 0) {
+        std::unique_ptr<juce::XmlElement> xml = juce::XmlDocument::parse(state.toString());
+        if (xml != nullptr) {
+            return processor.applyXmlState(*xml);
+        }
+        return processor.applyState(state.getData(), (int)state.getSize());
+    }
+    for (int i = 0; i < processor.getNumPrograms(); ++i) {
+        if (processor.getProgramName(i).equalsIgnoreCase(preset)) {
+            processor.setCurrentProgram(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+struct RenderResult {
+    bool ok = false;
+    juce::String error;
+    double audio_seconds = 0;
+    double render_seconds = 0;
+    InstrumentationReport stats;
+};
+
+// The share of the time each stage took, the worst block, and anything amiss in the signal
+static juce::String describeStats(const InstrumentationReport& r) {
+    juce::String s = "   ";
+    for (int stage = 0; stage < NUM_STAGES; ++stage) {
+        s += " " + juce::String(STAGE_NAMES[stage]) + " "
+            + juce::String(100.0 * r.stage_ticks[stage] / juce::jmax<int64_t>(1, r.block_ticks), 1) + "%";
+    }
+    s += ", worst block " + juce::String(100 * r.worst_block_load, 1) + "% of real time";
+    s += ", " + juce::String(r.nan_samples) + " NaN and " + juce::String(r.denormal_samples) + " denormal samples";
+    s += ", " + juce::String(r.rebuilds) + " rebuilds, the slowest "
+        + juce::String(1000.0 * r.worst_rebuild_ticks / r.ticks_per_second, 2) + " ms";
+    if (r.curve_nan_points > 0) {
+        s += ", " + juce::String(r.curve_nan_points) + " NaN points in the curve";
+    }
+    return s;
+}
+
+static RenderResult renderFile(Proto_galoisAudioProcessor& processor, juce::AudioFormatManager& formats,
+    const juce::File& input, const RenderOptions& options) {
+    RenderResult result;
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+    if (reader == nullptr) {
+        result.error = "cannot read " + input.getFullPathName();
+        return result;
+    }
+    juce::AudioFormat* format = formats.findFormatForFileExtension(input.getFileExtension());
+    juce::File output = options.output_directory.getChildFile(input.getFileName());
+    output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(output.createOutputStream());
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if (format != nullptr && stream != nullptr) {
+        writer.reset(format->createWriterFor(stream.get(), reader->sampleRate, reader->numChannels,
+            (int)reader->bitsPerSample, reader->metadataValues, 0));
+    }
+    if (writer == nullptr) {
+        result.error = "cannot write " + output.getFullPathName();
+        return result;
+    }
+    stream.release();
+
+    const int channels = (int)reader->numChannels;
+    const int block_size = options.block_size;
+    processor.setInstrumentationEnabled(options.print_stats);
+    processor.resetInstrumentation();
+    processor.setPlayConfigDetails(channels, channels, reader->sampleRate, block_size);
+    processor.prepareToPlay(reader->sampleRate, block_size);
+
+    juce::int64 length = reader->lengthInSamples;
+    if (options.render_tail) {
+        length += processor.getLatencySamples() + (juce::int64)ceil(processor.getTailLengthSeconds() * reader->sampleRate);
+    }
+
+    // Reading past the end of the file gives silence, which runs out the tail
+    juce::AudioBuffer<float> buffer(channels, block_size);
+    juce::MidiBuffer midi;
+    auto start = std::chrono::steady_clock::now();
+    for (juce::int64 position = 0; position < length; position += block_size) {
+        int n = (int)juce::jmin<juce::int64>(block_size, length - position);
+        buffer.setSize(channels, n, false, false, true);
+        reader->read(&buffer, 0, n, position, true, true);
+        processor.processBlock(buffer, midi);
+        writer->writeFromAudioSampleBuffer(buffer, 0, n);
+    }
+    result.render_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.audio_seconds = length / reader->sampleRate;
+    result.stats = processor.getInstrumentationReport();
+    processor.releaseResources();
+    result.ok = true;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    RenderOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    if (!options.output_directory.createDirectory()) {
+        std::cerr << "cannot create " << options.output_directory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // The processors are set up on the message thread, which builds their
+    // parameter snapshots there and then. processBlock() does the same for
+    // anything that changes afterwards, as the processors render offline.
+    juce::ScopedJuceInitialiser_GUI juce_initialiser;
+    juce::MemoryBlock state = loadStateFile(options.preset);
+    std::vector<std::unique_ptr<Proto_galoisAudioProcessor>> processors;
+    for (int i = 0; i < options.num_threads; ++i) {
+        processors.push_back(std::make_unique<Proto_galoisAudioProcessor>());
+        processors.back()->setNonRealtime(true);
+        if (!applyPreset(*processors.back(), options.preset, state)) {
+            std::cerr << "no preset or state file " << options.preset << std::endl;
+            return 1;
+        }
+    }
+
+    std::atomic<int> next_file { 0 };
+    std::atomic<int> failures { 0 };
+    std::mutex report_lock;
+    double total_audio_seconds = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < options.num_threads; ++w) {
+        workers.emplace_back([&, w] {
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+            for (int i = next_file++; i < options.files.size(); i = next_file++) {
+                const juce::File& input = options.files.getReference(i);
+                RenderResult result = renderFile(*processors[w], formats, input, options);
+                std::lock_guard<std::mutex> lock(report_lock);
+                if (!result.ok) {
+                    std::cerr << result.error << std::endl;
+                    failures++;
+                    continue;
+                }
+                total_audio_seconds += result.audio_seconds;
+                std::cout << input.getFileName() << ": " << juce::String(result.audio_seconds, 2) << " s in "
+                          << juce::String(result.render_seconds, 2) << " s, "
+                          << juce::String(result.audio_seconds / juce::jmax(1e-9, result.render_seconds), 1) << "x realtime" << std::endl;
+                if (options.print_stats) {
+                    std::cout << describeStats(result.stats) << std::endl;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << options.files.size() - failures << " files, " << juce::String(total_audio_seconds, 2) << " s of audio in "
+              << juce::String(elapsed, 2) << " s on " << options.num_threads << " threads, "
+              << juce::String(total_audio_seconds / juce::jmax(1e-9, elapsed), 1) << "x realtime" << std::endl;
+    return failures > 0 ? 1 : 0;
+}
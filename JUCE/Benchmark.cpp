@@ -0,0 +1,430 @@
+/*
+	Microbenchmarks, written out as JSON so that runs can be compared
+	across commits:
+
+		GaloisBenchmark --out results.json --label "after filter change"
+
+	Each entry gives the best of --repeats runs, in nanoseconds per sample,
+	or per call for the things that run once per parameter change:
+
+		waveform        each function in ptr[], over a sweep of [-1, 1]
+		stage           apply_power, apply_harmonics, apply_bit_mangling
+		                and apply_fold, on each side of zero where their
+		                code differs
+		filter          Biquad::apply per sample, filter_block per sample of
+		                each channel, over 1, 2 and 8 channels, and
+		                Biquad::recalculate per call
+		table           TransferTable::compile per call, plain and morphing,
+		                and a TransferTableCache hit per call
+		parameters      for each factory preset, cacheWaveforms() per call
+		                with nothing changed, and setCurrentProgram() per
+		                switch from another preset, with its curve already
+		                in the shared cache
+		preset          processBlock() per sample and channel, on stereo
+		                noise and a sine sweep, in blocks of --block samples
+		precision       the same for each preset on float buffers, on double
+		                buffers converted to float and back the way a host
+		                does for a float-only processor, and on double
+		                buffers natively (float builds only)
+		channels        the same for the first preset on 1, 2, 6 and 12
+		                channels, each with its own input; samples per
+		                second per channel are 1e9 / ns
+		algorithm       the same for each of the 120 algorithms, named by
+		                their stage order, on the direct engine with
+		                waveform 5 and every stage active (float builds
+		                only, as the integer engine has no direct engine)
+
+	The processor runs in real time, as it does in a host's playback, so
+	processBlock() is timed without the timerCallback() call it makes on
+	every block when rendering offline.
+
+	This is the GaloisBenchmark target in CMakeLists.txt. It includes
+	PluginProcessor.cpp itself, to reach the processor's internals, so it is
+	built with PluginEditor.cpp, galois_dsp and the binary data but not
+	PluginProcessor.cpp, and with JucePlugin_Name defined.
+*/
+#include <JuceHeader.h>
+#include "PluginProcessor.cpp"
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+struct BenchmarkOptions {
+    juce::File output;
+    juce::String label;
+    int block_size = 512;
+    int repeats = 5;
+};
+
+struct BenchmarkResult {
+    juce::String group;
+    juce::String name;
+    juce::String unit;      // "sample" or "call"
+    double ns = 0;
+};
+
+// Keeps the compiler from dropping the work being timed
+static volatile float sink;
+
+static bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+    juce::File cwd = juce::File::getCurrentWorkingDirectory();
+    for (int i = 1; i < argc; ++i) {
+        juce::String arg(argv[i]);
+        bool has_value = i + 1 < argc;
+        if (arg == "--out" && has_value) {
+            options.output = cwd.getChildFile(argv[++i]);
+        }
+        else if (arg == "--label" && has_value) {
+            options.label = argv[++i];
+        }
+        else if (arg == "--block" && has_value) {
+            options.block_size = juce::String(argv[++i]).getIntValue();
+        }
+        else if (arg == "--repeats" && has_value) {
+            options.repeats = juce::String(argv[++i]).getIntValue();
+        }
+        else {
+            return false;
+        }
+    }
+    return options.block_size > 0 && options.repeats > 0;
+}
+
+// The best time of body() over the repeats, in ns per count
+template <typename F>
+static double timeBest(const BenchmarkOptions& options, int count, F&& body) {
+    body();
+    double best = 1e300;
+    for (int r = 0; r < options.repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = juce::jmin(best, ns);
+    }
+    return best / count;
+}
+
+// A sweep of [-1, 1], used as every kernel's input
+static std::vector<float> makeSweep(int n) {
+    std::vector<float> x(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = -1 + 2 * (i + 0.5f) / n;
+    }
+    return x;
+}
+
+template <typename F>
+static double timeKernel(const BenchmarkOptions& options, const std::vector<float>& x, F&& kernel) {
+    const int passes = 64;
+    return timeBest(options, passes * (int)x.size(), [&] {
+        float sum = 0;
+        for (int p = 0; p < passes; ++p) {
+            for (float sample : x) {
+                sum += kernel(sample);
+            }
+        }
+        sink = sum;
+    });
+}
+
+static void benchmarkKernels(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+    const std::vector<float> x = makeSweep(4096);
+    for (int wf = 0; wf < NUM_WFs; ++wf) {
+        results.push_back({ "waveform", wf_names[wf], "sample", timeKernel(options, x, ptr[wf]) });
+    }
+
+    results.push_back({ "stage", "apply_power(0.5)", "sample",
+        timeKernel(options, x, [](float v) { return apply_power(v, 0.5f); }) });
+    results.push_back({ "stage", "apply_power(-0.5)", "sample",
+        timeKernel(options, x, [](float v) { return apply_power(v, -0.5f); }) });
+    results.push_back({ "stage", "apply_harmonics(8, 0.5)", "sample",
+        timeKernel(options, x, [](float v) { return apply_harmonics(v, v, 8, 0.5f); }) });
+    results.push_back({ "stage", "apply_harmonics(8, -0.5)", "sample",
+        timeKernel(options, x, [](float v) { return apply_harmonics(v, v, 8, -0.5f); }) });
+    results.push_back({ "stage", "apply_bit_mangling(512, 0)", "sample",
+        timeKernel(options, x, [](float v) { return apply_bit_mangling(v, 512, 0); }) });
+    results.push_back({ "stage", "apply_bit_mangling(512, 85)", "sample",
+        timeKernel(options, x, [](float v) { return apply_bit_mangling(v, 512, 85); }) });
+    results.push_back({ "stage", "apply_bit_mangling(512, -85)", "sample",
+        timeKernel(options, x, [](float v) { return apply_bit_mangling(v, 512, -85); }) });
+    results.push_back({ "stage", "apply_fold(0.5)", "sample",
+        timeKernel(options, x, [](float v) { return apply_fold(v, 0.5f); }) });
+    results.push_back({ "stage", "apply_fold(-0.5)", "sample",
+        timeKernel(options, x, [](float v) { return apply_fold(v, -0.5f); }) });
+
+    Biquad filter;
+    filter.recalculate(48000, 1000, 0.5f, 0, LPF);
+    results.push_back({ "filter", "Biquad::apply", "sample",
+        timeKernel(options, x, [&](float v) { return filter.apply(v); }) });
+    // The chain's filter runs channels side by side, so its time is per sample of each channel
+    for (int channels : { 1, 2, MAX_FILTER_CHANNELS }) {
+        const int passes = 64;
+        std::vector<std::vector<float>> buffers(channels, x);
+        std::vector<Biquad::State> states(channels);
+        std::vector<float> scratch(REMAP_BLOCK_SIZE);
+        float* run[MAX_FILTER_CHANNELS];
+        Biquad::State* state[MAX_FILTER_CHANNELS];
+        for (int c = 0; c < channels; ++c) {
+            state[c] = &states[c];
+        }
+        results.push_back({ "filter", "filter_block, " + juce::String(channels) + " channels", "sample",
+            timeBest(options, passes * (int)x.size() * channels, [&] {
+            for (int p = 0; p < passes; ++p) {
+                for (int start = 0; start < (int)x.size(); start += REMAP_BLOCK_SIZE) {
+                    for (int c = 0; c < channels; ++c) {
+                        run[c] = buffers[c].data() + start;
+                    }
+                    filter_block(filter, state, run, channels, scratch.data(), REMAP_BLOCK_SIZE, 0.5f, 0.5f);
+                }
+            }
+            sink = buffers[0][0];
+        }) });
+    }
+    const int designs = 1000;
+    results.push_back({ "filter", "Biquad::recalculate", "call", timeBest(options, designs, [&] {
+        for (int i = 0; i < designs; ++i) {
+            filter.recalculate(48000, 100.0f + i, 0.5f, 6, i % 7);
+        }
+        sink = filter.apply(1);
+    }) });
+
+    RemapParams params;
+    params.wf = 5;
+    params.power = 0.25f;
+    params.harm_amp = 0.5f;
+    TransferTable table;
+    results.push_back({ "table", "TransferTable::compile", "call", timeBest(options, 1, [&] {
+        table.compile(params);
+    }) });
+    RemapParams morph_params = params;
+    morph_params.morph = true;
+    results.push_back({ "table", "TransferTable::compile (morph)", "call", timeBest(options, 1, [&] {
+        table.compile(morph_params);
+    }) });
+    TransferTableCache& cache = TransferTableCache::getInstance();
+    std::shared_ptr<const TransferTable> held = cache.get(params);
+    const int lookups = 1000;
+    results.push_back({ "table", "TransferTableCache::get (hit)", "call", timeBest(options, lookups, [&] {
+        for (int i = 0; i < lookups; ++i) {
+            held = cache.get(params);
+        }
+    }) });
+}
+
+// Two seconds of input: one of noise, then a sweep from 20 Hz to 20 kHz
+static juce::AudioBuffer<float> makeInput(int channels, double sample_rate) {
+    const int length = (int)sample_rate;
+    juce::AudioBuffer<float> input(channels, 2 * length);
+    juce::Random random(1);
+    for (int c = 0; c < channels; ++c) {
+        float* x = input.getWritePointer(c);
+        double phase = 0;
+        for (int i = 0; i < length; ++i) {
+            x[i] = 0.5f * (2 * random.nextFloat() - 1);
+            phase += 2 * M_PI * 20 * pow(1000.0, (double)i / length) / sample_rate;
+            x[length + i] = (float)(0.8 * sin(phase + c));
+        }
+    }
+    return input;
+}
+
+static void setParameter(Proto_galoisAudioProcessor& processor, const char* id, float value) {
+    juce::RangedAudioParameter* parameter = processor.tree.getParameter(id);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+// processBlock() over input in blocks of --block samples, per sample and
+// channel. With P other than S, each block is converted to P and back, as a
+// host does for a processor that does not take its precision.
+template <typename S, typename P = S>
+static double timeProcessBlock(const BenchmarkOptions& options, Proto_galoisAudioProcessor& processor,
+                               const juce::AudioBuffer<S>& input, double sample_rate) {
+    const int channels = input.getNumChannels();
+    processor.setPlayConfigDetails(channels, channels, sample_rate, options.block_size);
+    processor.prepareToPlay(sample_rate, options.block_size);
+    juce::AudioBuffer<S> buffer(channels, options.block_size);
+    juce::AudioBuffer<P> converted(channels, options.block_size);
+    juce::MidiBuffer midi;
+    double ns = timeBest(options, input.getNumSamples() * channels, [&] {
+        for (int start = 0; start < input.getNumSamples(); start += options.block_size) {
+            int n = juce::jmin(options.block_size, input.getNumSamples() - start);
+            buffer.setSize(channels, n, false, false, true);
+            for (int c = 0; c < channels; ++c) {
+                buffer.copyFrom(c, 0, input, c, start, n);
+            }
+            if constexpr (std::is_same<S, P>::value) {
+                processor.processBlock(buffer, midi);
+            }
+            else {
+                converted.setSize(channels, n, false, false, true);
+                for (int c = 0; c < channels; ++c) {
+                    const S* from = buffer.getReadPointer(c);
+                    P* to = converted.getWritePointer(c);
+                    for (int i = 0; i < n; ++i) {
+                        to[i] = (P)from[i];
+                    }
+                }
+                processor.processBlock(converted, midi);
+                for (int c = 0; c < channels; ++c) {
+                    const P* from = converted.getReadPointer(c);
+                    S* to = buffer.getWritePointer(c);
+                    for (int i = 0; i < n; ++i) {
+                        to[i] = (S)from[i];
+                    }
+                }
+            }
+        }
+        sink = (float)buffer.getSample(0, 0);
+    });
+    processor.releaseResources();
+    return ns;
+}
+
+static void benchmarkPresets(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+    const double sample_rate = 48000;
+    const juce::AudioBuffer<float> input = makeInput(2, sample_rate);
+
+    Proto_galoisAudioProcessor processor;
+    // As in a host's playback. Offline, processBlock() would call
+    // timerCallback() itself on every block; here the changes below rebuild
+    // the snapshot as they are made, on the message thread.
+    processor.setNonRealtime(false);
+    for (int program = 0; program < processor.getNumPrograms(); ++program) {
+        juce::String name = processor.getProgramName(program);
+        double best_switch = 1e300;
+        for (int r = 0; r <= options.repeats; ++r) {
+            processor.setCurrentProgram(program == 0 ? 1 : 0);
+            auto start = std::chrono::steady_clock::now();
+            processor.setCurrentProgram(program);
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best_switch = juce::jmin(best_switch, ns);
+        }
+        results.push_back({ "parameters", "setCurrentProgram: " + name, "call", best_switch });
+
+        const int rebuilds = 20;
+        results.push_back({ "parameters", "cacheWaveforms: " + name, "call", timeBest(options, rebuilds, [&] {
+            for (int i = 0; i < rebuilds; ++i) {
+                processor.cacheWaveforms();
+            }
+        }) });
+
+        results.push_back({ "preset", name, "sample", timeProcessBlock(options, processor, input, sample_rate) });
+    }
+}
+
+// Each preset on 64-bit buffers, processed natively and converted to float
+// and back, against the same preset's float time
+static void benchmarkPrecision(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+    const double sample_rate = 48000;
+    const juce::AudioBuffer<float> input = makeInput(2, sample_rate);
+    juce::AudioBuffer<double> input_double(input.getNumChannels(), input.getNumSamples());
+    for (int c = 0; c < input.getNumChannels(); ++c) {
+        for (int i = 0; i < input.getNumSamples(); ++i) {
+            input_double.setSample(c, i, input.getSample(c, i));
+        }
+    }
+
+    Proto_galoisAudioProcessor processor;
+    processor.setNonRealtime(false);
+    for (int program = 0; program < processor.getNumPrograms(); ++program) {
+        juce::String name = processor.getProgramName(program);
+        processor.setCurrentProgram(program);
+        results.push_back({ "precision", "float: " + name, "sample", timeProcessBlock(options, processor, input, sample_rate) });
+        results.push_back({ "precision", "double via float: " + name, "sample",
+            timeProcessBlock<double, float>(options, processor, input_double, sample_rate) });
+        if (processor.supportsDoublePrecisionProcessing()) {
+            results.push_back({ "precision", "double: " + name, "sample", timeProcessBlock(options, processor, input_double, sample_rate) });
+        }
+    }
+}
+
+// The first preset over more channels, whose inputs all differ so that none is mirrored
+static void benchmarkChannels(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+    const double sample_rate = 48000;
+    Proto_galoisAudioProcessor processor;
+    processor.setNonRealtime(false);
+    processor.setCurrentProgram(0);
+    for (int channels : { 1, 2, 6, 12 }) {
+        const juce::AudioBuffer<float> input = makeInput(channels, sample_rate);
+        results.push_back({ "channels", juce::String(channels) + " channels: " + processor.getProgramName(0), "sample",
+            timeProcessBlock(options, processor, input, sample_rate) });
+    }
+}
+
+#if !GALOIS_FIXED_POINT
+// By ALGO_ value
+const char* const ALGO_NAMES[] = { "wf", "power", "harmonics", "bit", "fold" };
+
+// Every algorithm on the direct engine, which the integer engine does not have
+static void benchmarkAlgorithms(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+    const double sample_rate = 48000;
+    const juce::AudioBuffer<float> input = makeInput(2, sample_rate);
+
+    Proto_galoisAudioProcessor processor;
+    processor.setNonRealtime(false);
+    // One waveform, with every stage doing some work, so that only the order differs
+    setParameter(processor, "remap_engine", REMAP_ENGINE_DIRECT);
+    setParameter(processor, "wf_base_wave", 5);
+    setParameter(processor, "wf_power", 0.25f);
+    setParameter(processor, "wf_harm_amp", 0.5f);
+    setParameter(processor, "wf_fold", 0.5f);
+    setParameter(processor, "bit_mask", 85);
+    for (int algorithm = 0; algorithm < NUM_ALGORITHMS; ++algorithm) {
+        setParameter(processor, "algorithm", algorithm);
+        juce::String name = juce::String(algorithm) + ":";
+        for (int stage = 0; stage < 5; ++stage) {
+            name += juce::String(stage == 0 ? " " : ", ") + ALGO_NAMES[ALGORITHMS[algorithm][stage]];
+        }
+        results.push_back({ "algorithm", name, "sample", timeProcessBlock(options, processor, input, sample_rate) });
+    }
+}
+#endif
+
+static juce::String quote(const juce::String& s) {
+    return "\"" + s.replace("\\", "\\\\").replace("\"", "\\\"") + "\"";
+}
+
+static void writeJson(std::ostream& out, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+    out << "{" << std::endl
+        << "  \"label\": " << quote(options.label) << "," << std::endl
+        << "  \"block_size\": " << options.block_size << "," << std::endl
+        << "  \"repeats\": " << options.repeats << "," << std::endl
+        << "  \"fixed_point\": " << (GALOIS_FIXED_POINT ? "true" : "false") << "," << std::endl
+        << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << "    { \"group\": " << quote(r.group) << ", \"name\": " << quote(r.name)
+            << ", \"unit\": " << quote(r.unit) << ", \"ns\": " << juce::String(r.ns, 3) << " }"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl
+        << "}" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        std::cerr << "usage: GaloisBenchmark [--out <file>] [--label <text>] [--block <samples>] [--repeats <count>]" << std::endl;
+        return 1;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juce_initialiser;
+    std::vector<BenchmarkResult> results;
+    benchmarkKernels(options, results);
+    benchmarkPresets(options, results);
+    benchmarkPrecision(options, results);
+    benchmarkChannels(options, results);
+#if !GALOIS_FIXED_POINT
+    benchmarkAlgorithms(options, results);
+#endif
+
+    if (options.output == juce::File()) {
+        writeJson(std::cout, options, results);
+        return 0;
+    }
+    std::ofstream file(options.output.getFullPathName().toStdString());
+    writeJson(file, options, results);
+    return file.good() ? 0 : 1;
+}
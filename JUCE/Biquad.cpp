@@ -1,141 +1,230 @@
-#include <math.h>
-#include <stdlib.h>
-
-#ifndef M_LN2
-#define M_LN2	   0.69314718055994530942
-#endif
-
-#ifndef M_PI
-#define M_PI		3.14159265358979323846
-#endif
-
-/* filter types */
-enum {
-    LPF, /* low pass filter */
-    HPF, /* High pass filter */
-    BPF, /* band pass filter */
-    NOTCH, /* Notch Filter */
-    PEQ, /* Peaking band EQ filter */
-    LSH, /* Low shelf filter */
-    HSH /* High shelf filter */
-};
-
-class Biquad
-{
-public:
-    //==============================================================================
-    float apply(float sample) {
-        float result;
-        if (!initialized) {
-            return sample;
-        }
-
-        /* compute result */
-        result = biquad_a0 * sample 
-            + biquad_a1 * biquad_x1 
-            + biquad_a2 * biquad_x2 
-            - biquad_a3 * biquad_y1 
-            - biquad_a4 * biquad_y2;
-
-        /* shift x1 to x2, sample to x1 */
-        biquad_x2 = biquad_x1;
-        biquad_x1 = sample;
-
-        /* shift y1 to y2, result to y1 */
-        biquad_y2 = biquad_y1;
-        biquad_y1 = result;
-
-        return result;
-    }
-
-    void recalculate(float sample_rate, float frequency, float bandwidth, float gain, int type) {
-        float A, omega, sn, cs, alpha, beta;
-        float a0, a1, a2, b0, b1, b2;
-
-        /* setup variables */
-        A = pow(10, gain / 40);
-        omega = 2 * M_PI * frequency / sample_rate;
-        sn = sin(omega);
-        cs = cos(omega);
-        alpha = sn * sinh(M_LN2 / 2 * bandwidth * omega / sn);
-        beta = sqrt(A + A);
-
-        switch (type) {
-        case LPF:
-            b0 = (1 - cs) / 2;
-            b1 = 1 - cs;
-            b2 = (1 - cs) / 2;
-            a0 = 1 + alpha;
-            a1 = -2 * cs;
-            a2 = 1 - alpha;
-            break;
-        case HPF:
-            b0 = (1 + cs) / 2;
-            b1 = -(1 + cs);
-            b2 = (1 + cs) / 2;
-            a0 = 1 + alpha;
-            a1 = -2 * cs;
-            a2 = 1 - alpha;
-            break;
-        case BPF:
-            b0 = alpha;
-            b1 = 0;
-            b2 = -alpha;
-            a0 = 1 + alpha;
-            a1 = -2 * cs;
-            a2 = 1 - alpha;
-            break;
-        case NOTCH:
-            b0 = 1;
-            b1 = -2 * cs;
-            b2 = 1;
-            a0 = 1 + alpha;
-            a1 = -2 * cs;
-            a2 = 1 - alpha;
-            break;
-        case PEQ:
-            b0 = 1 + (alpha * A);
-            b1 = -2 * cs;
-            b2 = 1 - (alpha * A);
-            a0 = 1 + (alpha / A);
-            a1 = -2 * cs;
-            a2 = 1 - (alpha / A);
-            break;
-        case LSH:
-            b0 = A * ((A + 1) - (A - 1) * cs + beta * sn);
-            b1 = 2 * A * ((A - 1) - (A + 1) * cs);
-            b2 = A * ((A + 1) - (A - 1) * cs - beta * sn);
-            a0 = (A + 1) + (A - 1) * cs + beta * sn;
-            a1 = -2 * ((A - 1) + (A + 1) * cs);
-            a2 = (A + 1) + (A - 1) * cs - beta * sn;
-            break;
-        case HSH:
-            b0 = A * ((A + 1) + (A - 1) * cs + beta * sn);
-            b1 = -2 * A * ((A - 1) + (A + 1) * cs);
-            b2 = A * ((A + 1) + (A - 1) * cs - beta * sn);
-            a0 = (A + 1) - (A - 1) * cs + beta * sn;
-            a1 = 2 * ((A - 1) - (A + 1) * cs);
-            a2 = (A + 1) - (A - 1) * cs - beta * sn;
-            break;
-        }
-
-        /* precompute the coefficients */
-        biquad_a0 = b0 / a0;
-        biquad_a1 = b1 / a0;
-        biquad_a2 = b2 / a0;
-        biquad_a3 = a1 / a0;
-        biquad_a4 = a2 / a0;
-
-        /* zero initial samples */
-        //biquad_x1 = biquad_x2 = 0;
-        //biquad_y1 = biquad_y2 = 0;
-
-        initialized = true;
-    }
-
-private:
-    float biquad_a0 = 0, biquad_a1 = 0, biquad_a2 = 0, biquad_a3 = 0, biquad_a4 = 0;
-    float biquad_x1 = 0, biquad_x2 = 0, biquad_y1 = 0, biquad_y2 = 0;
-    bool initialized = false;
-
+#pragma once
+#include <math.h>
+#include <stdlib.h>
+
+#ifndef M_LN2
+#define M_LN2	   0.69314718055994530942
+#endif
+
+#ifndef M_PI
+#define M_PI		3.14159265358979323846
+#endif
+
+/* filter types */
+enum {
+    LPF, /* low pass filter */
+    HPF, /* High pass filter */
+    BPF, /* band pass filter */
+    NOTCH, /* Notch Filter */
+    PEQ, /* Peaking band EQ filter */
+    LSH, /* Low shelf filter */
+    HSH /* High shelf filter */
+};
+
+class Biquad
+{
+public:
+    //==============================================================================
+    float apply(float sample) {
+        float result;
+        if (!initialized) {
+            return sample;
+        }
+
+        /* compute result */
+        result = biquad_a0 * sample 
+            + biquad_a1 * biquad_x1 
+            + biquad_a2 * biquad_x2 
+            - biquad_a3 * biquad_y1 
+            - biquad_a4 * biquad_y2;
+
+        /* shift x1 to x2, sample to x1 */
+        biquad_x2 = biquad_x1;
+        biquad_x1 = sample;
+
+        /* shift y1 to y2, result to y1 */
+        biquad_y2 = biquad_y1;
+        biquad_y1 = result;
+
+        return result;
+    }
+
+    // Filter state in transposed direct form II, so that one set of
+    // coefficients can run over several channels. It is kept in double so
+    // that either sample type can use it. s1 leaves out the last result's
+    // feedback, which is y1, so that a run picks up exactly where the one
+    // before it stopped, however the samples are split between them.
+    struct State {
+        double s1 = 0, s2 = 0, y1 = 0;
+    };
+
+    // The filter over a run of float or double samples with an external
+    // state, held in locals. out may be the same buffer as in.
+    //
+    // Transposed direct form II carries two values rather than four, which
+    // is half as much to keep in registers when the filter runs channels
+    // side by side (see BlockStages.cpp). s1 is kept apart from the
+    // feedback term until the next sample, so that the recurrence from one
+    // result to the next is a multiply and a subtraction.
+    template <typename S>
+    void applyBlock(const S* in, S* out, int n, State& state) const {
+        if (!initialized) {
+            for (int i = 0; i < n; ++i) {
+                out[i] = in[i];
+            }
+            return;
+        }
+        const S b0 = biquad_a0, b1 = biquad_a1, b2 = biquad_a2, a1 = biquad_a3, a2 = biquad_a4;
+        S s1 = (S)state.s1, s2 = (S)state.s2, y1 = (S)state.y1;
+        for (int i = 0; i < n; ++i) {
+            S sample = in[i];
+            S result = b0 * sample + s1 - a1 * y1;
+            s1 = b1 * sample + s2;
+            s2 = b2 * sample - a2 * result;
+            y1 = result;
+            out[i] = result;
+        }
+        state.s1 = s1;
+        state.s2 = s2;
+        state.y1 = y1;
+    }
+
+    void recalculate(float sample_rate, float frequency, float bandwidth, float gain, int type) {
+        float A, omega, sn, cs, alpha, beta;
+        float a0, a1, a2, b0, b1, b2;
+
+        /* setup variables */
+        A = pow(10, gain / 40);
+        omega = 2 * M_PI * frequency / sample_rate;
+        sn = sin(omega);
+        cs = cos(omega);
+        alpha = sn * sinh(M_LN2 / 2 * bandwidth * omega / sn);
+        beta = sqrt(A + A);
+
+        switch (type) {
+        case LPF:
+            b0 = (1 - cs) / 2;
+            b1 = 1 - cs;
+            b2 = (1 - cs) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        case HPF:
+            b0 = (1 + cs) / 2;
+            b1 = -(1 + cs);
+            b2 = (1 + cs) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        case BPF:
+            b0 = alpha;
+            b1 = 0;
+            b2 = -alpha;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        case NOTCH:
+            b0 = 1;
+            b1 = -2 * cs;
+            b2 = 1;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        case PEQ:
+            b0 = 1 + (alpha * A);
+            b1 = -2 * cs;
+            b2 = 1 - (alpha * A);
+            a0 = 1 + (alpha / A);
+            a1 = -2 * cs;
+            a2 = 1 - (alpha / A);
+            break;
+        case LSH:
+            b0 = A * ((A + 1) - (A - 1) * cs + beta * sn);
+            b1 = 2 * A * ((A - 1) - (A + 1) * cs);
+            b2 = A * ((A + 1) - (A - 1) * cs - beta * sn);
+            a0 = (A + 1) + (A - 1) * cs + beta * sn;
+            a1 = -2 * ((A - 1) + (A + 1) * cs);
+            a2 = (A + 1) + (A - 1) * cs - beta * sn;
+            break;
+        case HSH:
+            b0 = A * ((A + 1) + (A - 1) * cs + beta * sn);
+            b1 = -2 * A * ((A - 1) + (A + 1) * cs);
+            b2 = A * ((A + 1) + (A - 1) * cs - beta * sn);
+            a0 = (A + 1) - (A - 1) * cs + beta * sn;
+            a1 = 2 * ((A - 1) - (A + 1) * cs);
+            a2 = (A + 1) - (A - 1) * cs - beta * sn;
+            break;
+        }
+
+        /* precompute the coefficients */
+        biquad_a0 = b0 / a0;
+        biquad_a1 = b1 / a0;
+        biquad_a2 = b2 / a0;
+        biquad_a3 = a1 / a0;
+        biquad_a4 = a2 / a0;
+
+        /* zero initial samples */
+        //biquad_x1 = biquad_x2 = 0;
+        //biquad_y1 = biquad_y2 = 0;
+
+        initialized = true;
+    }
+
+    // The normalised coefficients, in the order apply() uses them
+    void getCoefficients(float* coefficients) const {
+        coefficients[0] = biquad_a0;
+        coefficients[1] = biquad_a1;
+        coefficients[2] = biquad_a2;
+        coefficients[3] = biquad_a3;
+        coefficients[4] = biquad_a4;
+    }
+
+    // Takes coefficients from getCoefficients(), keeping the filter's state
+    void setCoefficients(const float* coefficients, bool is_initialized) {
+        biquad_a0 = coefficients[0];
+        biquad_a1 = coefficients[1];
+        biquad_a2 = coefficients[2];
+        biquad_a3 = coefficients[3];
+        biquad_a4 = coefficients[4];
+        initialized = is_initialized;
+    }
+
+    bool isInitialized() const {
+        return initialized;
+    }
+
+    // Samples until the impulse response has decayed below level, going by
+    // the radius of the poles. longest is what to report if it never does.
+    int getTailSamples(double level, int longest) const {
+        if (!initialized) {
+            return 0;
+        }
+        double discriminant = (double)biquad_a3 * biquad_a3 - 4.0 * biquad_a4;
+        double radius;
+        if (discriminant < 0) {
+            radius = sqrt((double)biquad_a4);
+        }
+        else {
+            radius = (fabs((double)biquad_a3) + sqrt(discriminant)) / 2;
+        }
+        if (radius >= 1) {
+            return longest;
+        }
+        // The feedforward half adds two samples
+        if (radius <= 0) {
+            return 2;
+        }
+        double samples = 2 + ceil(log(level) / log(radius));
+        return samples < longest ? (int)samples : longest;
+    }
+
+private:
+    float biquad_a0 = 0, biquad_a1 = 0, biquad_a2 = 0, biquad_a3 = 0, biquad_a4 = 0;
+    float biquad_x1 = 0, biquad_x2 = 0, biquad_y1 = 0, biquad_y2 = 0;
+    bool initialized = false;
+
 };
\ No newline at end of file
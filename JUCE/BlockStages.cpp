@@ -0,0 +1,221 @@
+/*
+	The processing chain around the remapper, one stage at a time. Each
+	stage is a kernel that works in place on a run of samples from one
+	channel, or from a group of channels, so processBlock can run the whole
+	chain over a sub-block a stage at a time rather than a sample at a
+	time. The stages that are plain arithmetic run on SIMD vectors (see
+	SIMD.cpp). The filter, which has a recurrence, runs its channels side
+	by side in the vector lanes instead, and keeps their state in registers
+	for the length of the run. The sample-and-hold is in Decimator.cpp.
+
+	The halvings after the filter blend and the dry blend are folded into
+	the gains the stages are given, which leaves the results unchanged.
+
+	The stages are templates on the sample type S, float or double, so the
+	chain runs at the host's precision. Only the float versions are written
+	on vfloat; the double versions are plain loops. The state they carry
+	between blocks is kept in double, which a float value round-trips
+	exactly. The remapper itself always runs in float.
+*/
+#pragma once
+#include "SIMD.cpp"
+#include "Biquad.cpp"
+#include <type_traits>
+
+template <typename S>
+inline void gain_block(S* x, int n, S gain) {
+	int i = 0;
+	if constexpr (std::is_same<S, float>::value) {
+		for (; i + VLANES <= n; i += VLANES) {
+			vstore(x + i, vload(x + i) * gain);
+		}
+	}
+	for (; i < n; ++i) {
+		x[i] = x[i] * gain;
+	}
+}
+
+/*
+	The filter runs over up to MAX_FILTER_CHANNELS channels at once, each
+	in a vector lane of its own, since its recurrence leaves nothing to
+	vectorise along a single channel: x[c] = filtered * wet + x[c] * dry.
+	VLANES samples of each channel are loaded at a time and transposed, so
+	that each vector holds one sample of every channel, and transposed back
+	to be stored. Lanes without a channel run on zeros. A channel left on
+	its own runs through applyBlock(), with scratch space for n samples.
+*/
+const int MAX_FILTER_CHANNELS = 8;
+static_assert(VLANES <= MAX_FILTER_CHANNELS, "A group of channels must fill a vector");
+
+template <typename S>
+inline void filter_block(const Biquad& filter, Biquad::State* const* state, S* const* x, int channels, S* scratch, int n, S wet, S dry) {
+	int c = 0;
+	if constexpr (std::is_same<S, float>::value) {
+		if (VLANES > 1 && filter.isInitialized()) {
+			float coefficients[5];
+			filter.getCoefficients(coefficients);
+			const vfloat b0 = coefficients[0], b1 = coefficients[1], b2 = coefficients[2];
+			const vfloat a1 = coefficients[3], a2 = coefficients[4];
+			const vfloat vwet = wet, vdry = dry;
+			for (; channels - c > 1; c += VLANES) {
+				const int lanes = channels - c < VLANES ? channels - c : VLANES;
+				float s1_lanes[VLANES] = {}, s2_lanes[VLANES] = {}, y1_lanes[VLANES] = {};
+				for (int k = 0; k < lanes; ++k) {
+					s1_lanes[k] = (float)state[c + k]->s1;
+					s2_lanes[k] = (float)state[c + k]->s2;
+					y1_lanes[k] = (float)state[c + k]->y1;
+				}
+				vfloat s1 = vload(s1_lanes), s2 = vload(s2_lanes), y1 = vload(y1_lanes);
+
+				// m samples from i, m no more than VLANES. The end of the run
+				// comes through a copy, padded with zeros.
+				auto run = [&](int i, int m) {
+					float part[VLANES] = {};
+					vfloat v[VLANES];
+					for (int k = 0; k < VLANES; ++k) {
+						if (k >= lanes) {
+							v[k] = 0.0f;
+						}
+						else if (m == VLANES) {
+							v[k] = vload(x[c + k] + i);
+						}
+						else {
+							std::memcpy(part, x[c + k] + i, sizeof(float) * m);
+							v[k] = vload(part);
+						}
+					}
+					transpose(v);
+					for (int j = 0; j < m; ++j) {
+						vfloat sample = v[j];
+						vfloat result = b0 * sample + s1 - a1 * y1;
+						s1 = b1 * sample + s2;
+						s2 = b2 * sample - a2 * result;
+						y1 = result;
+						v[j] = result * vwet + sample * vdry;
+					}
+					transpose(v);
+					for (int k = 0; k < lanes; ++k) {
+						if (m == VLANES) {
+							vstore(x[c + k] + i, v[k]);
+						}
+						else {
+							vstore(part, v[k]);
+							std::memcpy(x[c + k] + i, part, sizeof(float) * m);
+						}
+					}
+				};
+				int i = 0;
+				for (; i + VLANES <= n; i += VLANES) {
+					run(i, VLANES);
+				}
+				if (i < n) {
+					run(i, n - i);
+				}
+
+				vstore(s1_lanes, s1);
+				vstore(s2_lanes, s2);
+				vstore(y1_lanes, y1);
+				for (int k = 0; k < lanes; ++k) {
+					state[c + k]->s1 = s1_lanes[k];
+					state[c + k]->s2 = s2_lanes[k];
+					state[c + k]->y1 = y1_lanes[k];
+				}
+			}
+		}
+	}
+	for (; c < channels; ++c) {
+		S* channel = x[c];
+		filter.applyBlock(channel, scratch, n, *state[c]);
+		for (int i = 0; i < n; ++i) {
+			channel[i] = scratch[i] * wet + channel[i] * dry;
+		}
+	}
+}
+
+// x = dry_in * dry + x * wet
+template <typename S>
+inline void blend_block(S* x, const S* dry_in, int n, S dry, S wet) {
+	int i = 0;
+	if constexpr (std::is_same<S, float>::value) {
+		for (; i + VLANES <= n; i += VLANES) {
+			vstore(x + i, vload(dry_in + i) * dry + vload(x + i) * wet);
+		}
+	}
+	for (; i < n; ++i) {
+		x[i] = dry_in[i] * dry + x[i] * wet;
+	}
+}
+
+// Output level, clamped to [-1, 1]
+template <typename S>
+inline void output_block(S* x, int n, S gain) {
+	int i = 0;
+	if constexpr (std::is_same<S, float>::value) {
+		for (; i + VLANES <= n; i += VLANES) {
+			vfloat v = vload(x + i) * gain;
+			v = select(v > 1.0f, vfloat(1.0f), v);
+			v = select(v < -1.0f, vfloat(-1.0f), v);
+			vstore(x + i, v);
+		}
+	}
+	for (; i < n; ++i) {
+		S v = x[i] * gain;
+		v = v > 1 ? 1 : v;
+		x[i] = v < -1 ? -1 : v;
+	}
+}
+
+// The remapper's input: the samples themselves in float, or a converted copy
+inline float* remap_input(float* x, float*, int) {
+	return x;
+}
+
+inline float* remap_input(const double* x, float* converted, int n) {
+	for (int i = 0; i < n; ++i) {
+		converted[i] = (float)x[i];
+	}
+	return converted;
+}
+
+// Takes the remapper's output back from remap_input()'s buffer
+inline void remap_output(const float*, float*, int) {
+}
+
+inline void remap_output(const float* converted, double* x, int n) {
+	for (int i = 0; i < n; ++i) {
+		x[i] = converted[i];
+	}
+}
+
+/*
+	How long a channel's input has held one value, for the fast path that
+	skips the chain once its output has settled. Silence is the commonest
+	case. run only counts while the curve stands still, since a moving curve
+	changes the output of a constant input.
+*/
+struct SteadyInput {
+	double value = 0;
+	int run = 0;			// Samples the input has held value for
+	double output = 0;		// The last sample the chain produced
+};
+
+const int MAX_STEADY_RUN = 1 << 30;
+
+/*
+	Follows the input of a block. True if the whole block holds the value
+	the input had already held for settle samples, so that the chain's
+	output is steady.output throughout.
+*/
+template <typename S>
+inline bool track_steady_input(SteadyInput& steady, const S* x, int n, int settle) {
+	S last = x[n - 1];
+	int run = 1;
+	while (run < n && x[n - 1 - run] == last) {
+		++run;
+	}
+	bool constant = run == n && (double)last == steady.value;
+	bool settled = constant && steady.run >= settle;
+	steady.run = constant ? (steady.run < MAX_STEADY_RUN - n ? steady.run + n : MAX_STEADY_RUN) : run;
+	steady.value = last;
+	return settled;
+}
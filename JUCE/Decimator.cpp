@@ -0,0 +1,142 @@
+/*
+	Sample-and-hold decimation. Each channel captures its input once a
+	period and holds it until the next capture. The period need not be a
+	whole number of samples: a capture that falls between two samples takes
+	the value between them, by linear interpolation, so the rate can be set
+	in Hz and follow the host's sample rate. Each channel keeps its own
+	phase, so every channel captures at the same instants.
+
+	The hold runs a capture at a time rather than a sample at a time, so
+	there is no per-sample counter. In band-limited mode each step is
+	smoothed by a two-sample polynomial BLEP, which takes out most of the
+	aliasing the bare steps would add. Half of a BLEP comes before its step,
+	so that mode delays its output by one sample.
+
+	With a whole-number period and plain steps, a channel captures the same
+	samples as the old per-sample counter did.
+*/
+#pragma once
+#include <math.h>
+#include <stdint.h>
+
+/* what sets the hold period, as stored in the "hold_units" parameter */
+enum {
+	HOLD_UNITS_SAMPLES,		// "sample_rate", in samples
+	HOLD_UNITS_HZ			// "hold_rate", in Hz at the host's sample rate
+};
+
+/* steps, as stored in the "hold_step" parameter */
+enum {
+	HOLD_STEP_PLAIN,
+	HOLD_STEP_BAND_LIMITED
+};
+
+// The phase is kept in fixed point, 32.32, so it never drifts however the blocks fall
+typedef int64_t hold_time;
+const int HOLD_TIME_BITS = 32;
+const hold_time HOLD_TIME_ONE = (hold_time)1 << HOLD_TIME_BITS;
+
+inline hold_time to_hold_time(double samples) {
+	return (hold_time)(samples * HOLD_TIME_ONE + 0.5);
+}
+
+// Per-channel history
+struct DecimatorState {
+	double held = 0;		// The last capture
+	hold_time phase = 0;	// Samples from the last capture to the end of the last block, less one
+	double last_input = 0;	// The last block's last input, for a capture just before this block
+	double delayed = 0;		// Band-limited mode: the last block's last output, due next
+};
+
+// When the first capture of a block is due, in samples from its start
+inline hold_time first_capture(const DecimatorState& state, hold_time period) {
+	hold_time next = period - HOLD_TIME_ONE - state.phase;
+	// A period that has just got shorter may already have passed
+	return next <= -HOLD_TIME_ONE ? 0 : next;
+}
+
+// The first sample at or after a capture
+inline int capture_edge(hold_time next) {
+	return (int)((next + HOLD_TIME_ONE - 1) >> HOLD_TIME_BITS);
+}
+
+// The phase at the end of a block of n samples, given the first capture after it
+inline hold_time end_phase(hold_time next, int n, hold_time period) {
+	return period - HOLD_TIME_ONE - (next - ((hold_time)n << HOLD_TIME_BITS));
+}
+
+/*
+	Holds x in place, capturing every period samples. period is at least
+	one; at exactly one, with the phase on a whole sample, every sample is
+	its own capture and x is left as it is. A capture's step goes in with
+	its BLEP when band_limited is set: d is how far the capture is ahead
+	of the first sample that holds it, the held run before it gains
+	step * d^2 / 2 on its last sample, and the run after it loses
+	step * (1 - d)^2 / 2 on its first.
+*/
+template <typename S>
+inline void decimate_block(S* x, int n, DecimatorState& state, hold_time period, bool band_limited) {
+	const double last = x[n - 1];
+	if (period == HOLD_TIME_ONE && state.phase == 0) {
+		state.held = last;
+		state.last_input = last;
+		state.delayed = last;
+		return;
+	}
+	hold_time next = first_capture(state, period);
+	double held = state.held;
+	double after = 0;
+	int start = 0;
+	for (int edge = capture_edge(next); edge < n; next += period, edge = capture_edge(next)) {
+		double d = (double)(((hold_time)edge << HOLD_TIME_BITS) - next) / HOLD_TIME_ONE;
+		double previous = edge > 0 ? (double)x[edge - 1] : state.last_input;
+		double value = d > 0 ? x[edge] + (previous - x[edge]) * d : (double)x[edge];
+		for (int i = start; i < edge; ++i) {
+			x[i] = (S)held;
+		}
+		if (band_limited) {
+			double step = value - held;
+			if (start < edge) {
+				x[start] = (S)(x[start] - after);
+			}
+			if (edge > 0) {
+				x[edge - 1] = (S)(x[edge - 1] + step * d * d / 2);
+			}
+			else {
+				state.delayed += step * d * d / 2;
+			}
+			after = step * (1 - d) * (1 - d) / 2;
+		}
+		held = value;
+		start = edge;
+	}
+	for (int i = start; i < n; ++i) {
+		x[i] = (S)held;
+	}
+	if (band_limited) {
+		if (start < n) {
+			x[start] = (S)(x[start] - after);
+		}
+		double due = x[n - 1];
+		for (int i = n - 1; i > 0; --i) {
+			x[i] = x[i - 1];
+		}
+		x[0] = (S)state.delayed;
+		state.delayed = due;
+	}
+	state.held = held;
+	state.phase = end_phase(next, n, period);
+	state.last_input = last;
+}
+
+// Moves the phase on as decimate_block() would, for a block of the constant input already held
+inline void skip_decimator(DecimatorState& state, int n, hold_time period) {
+	if (period == HOLD_TIME_ONE && state.phase == 0) {
+		return;
+	}
+	hold_time next = first_capture(state, period);
+	while (capture_edge(next) < n) {
+		next += period;
+	}
+	state.phase = end_phase(next, n, period);
+}
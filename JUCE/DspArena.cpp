@@ -0,0 +1,102 @@
+/*
+	One allocation for all of an instance's per-channel DSP state, so that
+	nothing the audio thread touches is allocated piecemeal. prepareToPlay()
+	lays the state out in the arena, then lays it out again if it did not
+	fit, after growing the arena to the size the first pass needed. The
+	arena is only ever released whole, so everything allocated from it must
+	be trivially destructible.
+
+	Allocations are aligned to cache lines, so that state belonging to
+	different channels never shares one.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+const size_t ARENA_ALIGNMENT = 64;
+
+class DspArena
+{
+public:
+    ~DspArena() {
+        release();
+        std::free(raw_buffer);
+    }
+
+    // Starts a new layout. Anything allocated before is discarded.
+    void begin() {
+        release();
+        used = 0;
+    }
+
+    // True if everything allocated since begin() is in the arena itself
+    bool fits() const {
+        return used <= capacity;
+    }
+
+    // Makes room for everything allocated since begin(). Call begin() and lay out again afterwards.
+    void grow() {
+        if (fits()) {
+            return;
+        }
+        release();
+        std::free(raw_buffer);
+        buffer = allocate_aligned(used, raw_buffer);
+        capacity = used;
+    }
+
+    // count value-initialised Ts. If the arena is full, they come from the heap until the next begin().
+    template <typename T>
+    T* allocate(int count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+        static_assert(alignof(T) <= ARENA_ALIGNMENT, "arena allocations are cache-line aligned");
+        size_t bytes = round_up(sizeof(T) * (count > 0 ? count : 1));
+        char* memory;
+        if (used + bytes <= capacity) {
+            memory = buffer + used;
+        }
+        else {
+            void* raw;
+            memory = allocate_aligned(bytes, raw);
+            overflow.push_back(raw);
+        }
+        used += bytes;
+        T* result = reinterpret_cast<T*>(memory);
+        for (int i = 0; i < count; ++i) {
+            new (result + i) T();
+        }
+        return result;
+    }
+
+    size_t getSize() const {
+        return capacity;
+    }
+
+private:
+    char* buffer = 0;
+    void* raw_buffer = 0;
+    size_t capacity = 0;
+    size_t used = 0;
+    std::vector<void*> overflow;
+
+    static size_t round_up(size_t bytes) {
+        return (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    }
+
+    // raw is what to free afterwards
+    static char* allocate_aligned(size_t bytes, void*& raw) {
+        raw = std::malloc(bytes + ARENA_ALIGNMENT);
+        size_t address = (size_t)raw;
+        return (char*)((address + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT);
+    }
+
+    void release() {
+        for (void* raw : overflow) {
+            std::free(raw);
+        }
+        overflow.clear();
+    }
+};
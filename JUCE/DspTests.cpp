@@ -0,0 +1,316 @@
+/*
+	Unit checks for galois_dsp, which need nothing but the standard library:
+
+		GaloisDspTests [test ...]
+
+	With no arguments every test runs, otherwise only the ones named. Each
+	prints its measurements and whether it passed, and the exit code is the
+	number of tests that failed. CMakeLists.txt registers each test with
+	CTest under its own name.
+*/
+#include "FastMath.cpp"
+#include "StateFormat.cpp"
+#include "BlockStages.cpp"
+#include "Decimator.cpp"
+#include "TransferTable.cpp"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+// fast_math: each PolyMath tier against the standard library in double, over
+// [-1, 1] and over the arguments the waveforms and stages reach (FastMath.cpp)
+
+// The bounds documented in FastMath.cpp and RemapParams.h
+const double PRECISE_MAX_ERROR = 2e-7;
+const double FAST_MAX_ERROR = 1.2e-4;
+const int MATH_SWEEP_POINTS = 1 << 18;
+
+// Absolute error, or relative where the result exceeds 1
+static double mathError(double actual, double expected) {
+	return std::abs(actual - expected) / std::max(1.0, std::abs(expected));
+}
+
+/*
+	Sweeps x over [lo, hi], evaluating f both on plain floats and on whole
+	vfloats, and returns the largest error against reference.
+*/
+template <typename F, typename R>
+static double sweepError(float lo, float hi, F f, R reference) {
+	double worst = 0;
+	float lanes[VLANES];
+	for (int i = 0; i <= MATH_SWEEP_POINTS; i += VLANES) {
+		for (int l = 0; l < VLANES; ++l) {
+			lanes[l] = lo + (hi - lo) * (float)std::min(i + l, MATH_SWEEP_POINTS) / MATH_SWEEP_POINTS;
+		}
+		float results[VLANES];
+		vstore(results, f(vload(lanes)));
+		for (int l = 0; l < VLANES; ++l) {
+			double expected = reference((double)lanes[l]);
+			worst = std::max(worst, mathError(f(lanes[l]), expected));
+			worst = std::max(worst, mathError(results[l], expected));
+		}
+	}
+	return worst;
+}
+
+template <typename M>
+static bool checkMathTier(const char* name, double bound) {
+	struct Range {
+		const char* function;
+		float lo, hi;
+		double error;
+	};
+	// The exponents apply_power() uses run from 0 to 11, on magnitudes in [0, 1]
+	const float exponents[] = { 0.0f, 0.1f, 0.5f, 0.9f, 1.0f, 2.5f, 6.0f, 11.0f };
+	double pow_error = 0;
+	for (float y : exponents) {
+		pow_error = std::max(pow_error, sweepError(0.0f, 1.0f,
+			[y](auto x) { return M::pow(x, y); }, [y](double x) { return std::pow(x, (double)y); }));
+	}
+	Range ranges[] = {
+		{ "sin", -1, 1, sweepError(-1.0f, 1.0f, [](auto x) { return M::sin(x); }, [](double x) { return std::sin(x); }) },
+		{ "sin", -600, 600, sweepError(-600.0f, 600.0f, [](auto x) { return M::sin(x); }, [](double x) { return std::sin(x); }) },
+		{ "cos", -1, 1, sweepError(-1.0f, 1.0f, [](auto x) { return M::cos(x); }, [](double x) { return std::cos(x); }) },
+		{ "cos", -600, 600, sweepError(-600.0f, 600.0f, [](auto x) { return M::cos(x); }, [](double x) { return std::cos(x); }) },
+		{ "tanh", -1, 1, sweepError(-1.0f, 1.0f, [](auto x) { return M::tanh(x); }, [](double x) { return std::tanh(x); }) },
+		{ "tanh", -40, 40, sweepError(-40.0f, 40.0f, [](auto x) { return M::tanh(x); }, [](double x) { return std::tanh(x); }) },
+		{ "sinh", -1, 1, sweepError(-1.0f, 1.0f, [](auto x) { return M::sinh(x); }, [](double x) { return std::sinh(x); }) },
+		{ "sinh", -8, 8, sweepError(-8.0f, 8.0f, [](auto x) { return M::sinh(x); }, [](double x) { return std::sinh(x); }) },
+		{ "asin", -1, 1, sweepError(-1.0f, 1.0f, [](auto x) { return M::asin(x); }, [](double x) { return std::asin(x); }) },
+		{ "floor", -600, 600, sweepError(-600.0f, 600.0f, [](auto x) { return M::floor(x); }, [](double x) { return std::floor(x); }) },
+		{ "pow", 0, 1, pow_error },
+	};
+	bool passed = true;
+	for (const Range& range : ranges) {
+		bool ok = range.error <= bound;
+		printf("  %s %-6s [%g, %g]: %.3g%s\n", name, range.function, range.lo, range.hi, range.error, ok ? "" : " FAILED");
+		passed = passed && ok;
+	}
+	return passed;
+}
+
+static bool testFastMath() {
+	bool precise = checkMathTier<VecMath>("precise", PRECISE_MAX_ERROR);
+	bool fast = checkMathTier<FastMath>("fast", FAST_MAX_ERROR);
+	return precise && fast;
+}
+
+//==============================================================================
+// state_round_trip: the binary state in StateFormat.cpp, without JUCE
+
+static bool sameValues(const ParameterValues& a, const ParameterValues& b, int count) {
+	for (int i = 0; i < count; ++i) {
+		if (memcmp(&a.value[i], &b.value[i], sizeof(float)) != 0 || a.is_set[i] != b.is_set[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool check(bool condition, const char* what) {
+	printf("  %s%s\n", what, condition ? "" : " FAILED");
+	return condition;
+}
+
+static bool testStateRoundTrip() {
+	ParameterValues written;
+	for (int i = 0; i < NUM_STATE_PARAMETERS; ++i) {
+		written.value[i] = (i % 2 ? -1.0f : 1.0f) * (i + 0.1f * i * i);
+		written.is_set[i] = true;
+	}
+	std::vector<uint8_t> data;
+	writeBinaryState(written, data);
+	bool passed = check(data.size() == (size_t)STATE_HEADER_BYTES + 4 * NUM_STATE_PARAMETERS, "size");
+	passed &= check(memcmp(data.data(), "GALS", 4) == 0, "magic is little-endian");
+
+	ParameterValues read;
+	passed &= check(readBinaryState(data.data(), (int)data.size(), read) && sameValues(read, written, NUM_STATE_PARAMETERS),
+		"every value round trips exactly");
+
+	// An older version of the state, with only the first three parameters
+	std::vector<uint8_t> older(data.begin(), data.begin() + STATE_HEADER_BYTES + 3 * 4);
+	older[8] = 3;
+	ParameterValues from_older;
+	passed &= check(readBinaryState(older.data(), (int)older.size(), from_older) && sameValues(from_older, written, 3)
+		&& !from_older.is_set[3] && !from_older.is_set[NUM_STATE_PARAMETERS - 1], "an older state sets only its own values");
+
+	// A newer version, with two more parameters than this one knows
+	std::vector<uint8_t> newer = data;
+	newer[4] = 2;
+	newer[8] = NUM_STATE_PARAMETERS + 2;
+	newer.resize(newer.size() + 8, 0x7f);
+	ParameterValues from_newer;
+	passed &= check(readBinaryState(newer.data(), (int)newer.size(), from_newer) && sameValues(from_newer, written, NUM_STATE_PARAMETERS),
+		"a newer state's extra values are skipped");
+
+	ParameterValues rejected;
+	const char xml[] = "<?xml version=\"1.0\"?><Galois_Parameter_Tree/>";
+	passed &= check(!readBinaryState(data.data(), (int)data.size() - 1, rejected)
+		&& !readBinaryState(xml, (int)sizeof(xml), rejected)
+		&& !readBinaryState(data.data(), STATE_HEADER_BYTES - 1, rejected)
+		&& !readBinaryState(nullptr, 0, rejected), "truncated states, XML and nothing are rejected");
+	passed &= check(findStateParameter("curve_ramp") == NUM_STATE_PARAMETERS - 1 && findStateParameter("biquad_type") == -1,
+		"parameters are found by id");
+	return passed;
+}
+
+//==============================================================================
+// filter_split: filter_block() carries its whole state from one run to the
+// next, so a signal filtered in runs of any length comes out exactly as it
+// does in one, on the lanes and on the scalar path (BlockStages.cpp)
+
+template <typename S>
+static bool filterSplitMatches(const Biquad& filter, int channels) {
+	const int length = 1000;
+	const int runs[] = { 1, 7, 64, 3, 100, 2, 33 };
+	std::vector<std::vector<S>> whole(channels, std::vector<S>(length));
+	uint32_t seed = 1;
+	for (int c = 0; c < channels; ++c) {
+		for (int i = 0; i < length; ++i) {
+			seed = seed * 1664525 + 1013904223;
+			whole[c][i] = (S)((float)(seed >> 8) / (1 << 23) - 1);
+		}
+	}
+	std::vector<std::vector<S>> split = whole;
+	std::vector<S> scratch(length);
+	std::vector<Biquad::State> whole_states(channels), split_states(channels);
+	Biquad::State* state[MAX_FILTER_CHANNELS];
+	S* x[MAX_FILTER_CHANNELS];
+
+	for (int c = 0; c < channels; ++c) {
+		state[c] = &whole_states[c];
+		x[c] = whole[c].data();
+	}
+	filter_block(filter, state, x, channels, scratch.data(), length, (S)0.75, (S)0.25);
+	for (int start = 0, r = 0, n = 0; start < length; start += n, ++r) {
+		n = std::min(runs[r % 7], length - start);
+		for (int c = 0; c < channels; ++c) {
+			state[c] = &split_states[c];
+			x[c] = split[c].data() + start;
+		}
+		filter_block(filter, state, x, channels, scratch.data(), n, (S)0.75, (S)0.25);
+	}
+	return whole == split;
+}
+
+static bool testFilterSplit() {
+	Biquad filter;
+	filter.recalculate(48000, 1000, 0.5f, 0, LPF);
+	bool passed = true;
+	for (int channels : { 1, 2, 3, MAX_FILTER_CHANNELS }) {
+		char what[64];
+		snprintf(what, sizeof(what), "%d channels, float and double", channels);
+		passed &= check(filterSplitMatches<float>(filter, channels) && filterSplitMatches<double>(filter, channels), what);
+	}
+	return passed;
+}
+
+//==============================================================================
+// hold_counter: with a whole-number period and plain steps, the hold
+// captures the samples the old per-sample counter did, however the blocks
+// fall (Decimator.cpp)
+
+static bool testHoldCounter() {
+	const int length = 2000;
+	const int runs[] = { 1, 7, 64, 3, 100, 2, 333 };
+	std::vector<float> input(length);
+	uint32_t seed = 1;
+	for (int i = 0; i < length; ++i) {
+		seed = seed * 1664525 + 1013904223;
+		input[i] = (float)(seed >> 8) / (1 << 23) - 1;
+	}
+	bool passed = true;
+	for (int period : { 1, 2, 3, 7, 64, 256 }) {
+		// The counter: a capture on every period-th sample, and zero before the first
+		std::vector<float> counted(length);
+		int counter = 0;
+		float held = 0;
+		for (int i = 0; i < length; ++i) {
+			if (++counter >= period) {
+				counter = 0;
+				held = input[i];
+			}
+			counted[i] = held;
+		}
+
+		std::vector<float> x = input;
+		DecimatorState state;
+		for (int start = 0, r = 0, n = 0; start < length; start += n, ++r) {
+			n = std::min(runs[r % 7], length - start);
+			decimate_block(x.data() + start, n, state, to_hold_time(period), false);
+		}
+		char what[64];
+		snprintf(what, sizeof(what), "period %d", period);
+		passed &= check(x == counted, what);
+	}
+	return passed;
+}
+
+//==============================================================================
+// morph_bank: a morphing table's bank holds each waveform's plain curve, so
+// morphing to a waveform sounds as choosing it does (TransferTable.cpp)
+
+static bool testMorphBank() {
+	RemapParams params;
+	params.power = 0.25f;
+	params.harm_amp = 0.5f;
+	params.fold_amt = 0.5f;
+	RemapParams morph_params = params;
+	morph_params.morph = true;
+	TransferTable morph;
+	morph.compile(morph_params);
+
+	int mismatches = 0;
+	TransferTable plain;
+	for (int wf = 0; wf < NUM_WFs; ++wf) {
+		params.wf = wf;
+		plain.compile(params);
+		// Past the table's range too, where both fall back to remap_sample()
+		for (int i = 0; i <= 4000; ++i) {
+			float x = -10 + i * 0.005f;
+			float expected = plain.lookup(x);
+			float actual = morph.lookupMorph(x, (float)wf);
+			// The last waveform is the far end of the last pair, which takes one rounding
+			bool same = wf < NUM_WFs - 1 ? actual == expected
+				: std::abs(actual - expected) <= 1e-6f * std::max(1.0f, std::abs(expected));
+			mismatches += !same;
+		}
+	}
+	return check(mismatches == 0, "every waveform's curve, in and out of the table's range");
+}
+
+//==============================================================================
+
+struct DspTest {
+	const char* name;
+	bool (*run)();
+};
+
+const DspTest DSP_TESTS[] = {
+	{ "fast_math", testFastMath },
+	{ "state_round_trip", testStateRoundTrip },
+	{ "filter_split", testFilterSplit },
+	{ "hold_counter", testHoldCounter },
+	{ "morph_bank", testMorphBank },
+};
+
+int main(int argc, char* argv[]) {
+	int failures = 0;
+	for (const DspTest& test : DSP_TESTS) {
+		bool selected = argc < 2;
+		for (int i = 1; i < argc; ++i) {
+			selected = selected || strcmp(argv[i], test.name) == 0;
+		}
+		if (!selected) {
+			continue;
+		}
+		printf("%s\n", test.name);
+		bool passed = test.run();
+		printf("%s: %s\n", test.name, passed ? "passed" : "FAILED");
+		failures += !passed;
+	}
+	return failures;
+}
@@ -0,0 +1,246 @@
+/*
+	The math layer used by the block waveforms and stages. A math policy
+	provides sin, cos, tanh, sinh, asin, floor and pow for plain floats and
+	SIMD vfloats, at one of the accuracy tiers in RemapParams.h:
+
+	MATH_EXACT    StdMath forwards to the standard library one lane at a time.
+	MATH_PRECISE  VecMath uses polynomial approximations on whole vectors.
+	              Maximum error 2e-7 against the standard library in double.
+	MATH_FAST     FastMath uses lower order approximations. Maximum error 1.2e-4.
+
+	The errors are absolute, or relative where the result exceeds 1. They hold
+	over [-1, 1] and over the wider arguments the waveforms actually produce:
+	sin and cos out to +-600 (w_bigcos and w_shcos at the edge of the transfer
+	table, and the sine fold), tanh out to +-40, sinh out to +-8, and pow of
+	[0, 1] for the exponents apply_power() uses. The fast_math test in
+	DspTests.cpp sweeps each of these and fails beyond the bounds above.
+
+	The tier selects the policy for remap_block(), which compiles the transfer
+	tables and runs the direct engine. The exact tier compiles through
+	remap_sample() instead, as do the few inputs outside the table, so that
+	path never goes through this layer.
+*/
+#pragma once
+#include "SIMD.cpp"
+#include "RemapParams.h"
+#include <cmath>
+
+//=======================================
+// Vectorisable math
+//=======================================
+
+template <typename T> inline T vm_floor(T x) {
+	T t = vtofloat(vtrunc(x));
+	return t - select(t > x, T(1.0f), T(0.0f));
+}
+
+template <typename T> inline T vm_sgn(T x) {
+	return select(x > 0.0f, T(1.0f), T(0.0f)) - select(x < 0.0f, T(1.0f), T(0.0f));
+}
+
+template <typename T> inline T vm_clamp(T val) {
+	val = select(val > 1.0f, T(1.0f), val);
+	return select(val < -1.0f, T(-1.0f), val);
+}
+
+// sin(x + quarter_turns * pi / 2), for quarter_turns of 0 or 1
+template <int TIER, int QUARTER_TURNS, typename T> inline T vm_sin_shifted(T x) {
+	// Reduce to r in [-pi/2, pi/2] with x = r + k * pi. The shift is added
+	// after the reduction, where it is exact in float even for large x.
+	T k = vm_floor(x * (1 / 3.14159265f) + (0.5f + 0.5f * QUARTER_TURNS));
+	T r = x - k * 3.140625f;
+	r = r - k * 9.67653589793e-4f;
+	if constexpr (QUARTER_TURNS == 1) {
+		r = r + 1.57079632679f;
+	}
+	T r2 = r * r;
+	T p;
+	if constexpr (TIER == MATH_FAST) {
+		p = 7.514376599e-3f;
+		p = p * r2 - 1.656730775e-1f;
+		p = p * r2 + 9.99696772e-1f;
+		p = r * p;
+	}
+	else {
+		p = -2.5052108385e-8f;
+		p = p * r2 + 2.7557319224e-6f;
+		p = p * r2 - 1.9841269841e-4f;
+		p = p * r2 + 8.3333333333e-3f;
+		p = p * r2 - 1.6666666667e-1f;
+		p = r + r * r2 * p;
+	}
+	// Odd k flips the sign
+	T odd = vtofloat(vtrunc(k) & 1);
+	return p * (1.0f - 2.0f * odd);
+}
+
+template <int TIER, typename T> inline T vm_sin(T x) {
+	return vm_sin_shifted<TIER, 0>(x);
+}
+
+template <int TIER, typename T> inline T vm_cos(T x) {
+	return vm_sin_shifted<TIER, 1>(x);
+}
+
+template <int TIER, typename T> inline T vm_exp(T x) {
+	T n = vm_floor(x * 1.44269504089f + 0.5f);
+	n = select(n > 127.0f, T(127.0f), n);
+	n = select(n < -126.0f, T(-126.0f), n);
+	T r = x - n * 0.693359375f;
+	r = r + n * 2.12194440e-4f;
+	T p;
+	if constexpr (TIER == MATH_FAST) {
+		p = 1.65668277e-1f;
+		p = p * r + 5.049632564e-1f;
+		p = p * r + 1.000164199f;
+		p = p * r + 9.99928074e-1f;
+	}
+	else {
+		p = 1.9875691500e-4f;
+		p = p * r + 1.3981999507e-3f;
+		p = p * r + 8.3334519073e-3f;
+		p = p * r + 4.1665795894e-2f;
+		p = p * r + 1.6666665459e-1f;
+		p = p * r + 5.0000001201e-1f;
+		p = p * r * r + r + 1.0f;
+	}
+	// Scale by 2^n by building the exponent bits directly
+	p = p * vint_as_float((vtrunc(n) + 127) << 23);
+	p = select(x < -87.0f, T(0.0f), p);
+	return select(x > 88.0f, T(1.7e38f), p);
+}
+
+// Natural log for x > 0
+template <int TIER, typename T> inline T vm_log(T x) {
+	auto bits = vfloat_as_int(x);
+	auto e = ((bits >> 23) & 0xff) - 127;
+	T m = vint_as_float((bits & 0x007fffff) | 0x3f800000);
+	// Keep the mantissa in [sqrt(0.5), sqrt(2)) so the series converges quickly
+	auto big = m > 1.41421356f;
+	m = select(big, m * 0.5f, m);
+	T ef = vtofloat(e) + select(big, T(1.0f), T(0.0f));
+	T s = (m - 1.0f) / (m + 1.0f);
+	T s2 = s * s;
+	T p;
+	if constexpr (TIER == MATH_FAST) {
+		p = s2 * 0.3363469464f + 1.0f;
+	}
+	else {
+		p = 1.0f / 9;
+		p = p * s2 + 1.0f / 7;
+		p = p * s2 + 1.0f / 5;
+		p = p * s2 + 1.0f / 3;
+		p = p * s2 + 1.0f;
+	}
+	return 2.0f * s * p + ef * 0.69314718056f;
+}
+
+// x^y for x >= 0, with 0^0 = 1 as in std::pow
+template <int TIER, typename T> inline T vm_pow(T x, T y) {
+	auto positive = x > 0.0f;
+	T p = vm_exp<TIER>(y * vm_log<TIER>(select(positive, x, T(1.0f))));
+	return select(positive, p, select(y == 0.0f, T(1.0f), T(0.0f)));
+}
+
+template <int TIER, typename T> inline T vm_tanh(T x) {
+	x = select(x > 9.0f, T(9.0f), x);
+	x = select(x < -9.0f, T(-9.0f), x);
+	T e = vm_exp<TIER>(2.0f * x);
+	return (e - 1.0f) / (e + 1.0f);
+}
+
+template <int TIER, typename T> inline T vm_sinh(T x) {
+	T e = vm_exp<TIER>(x);
+	return 0.5f * (e - 1.0f / e);
+}
+
+// Returns NaN outside [-1, 1], like std::asin
+template <int TIER, typename T> inline T vm_asin(T x) {
+	T a = vabs(x);
+	auto big = a > 0.5f;
+	T z = select(big, 0.5f * (1.0f - a), a * a);
+	T s = select(big, vsqrt(z), a);
+	T p;
+	if constexpr (TIER == MATH_FAST) {
+		p = 8.849404733e-2f;
+		p = p * z + 1.662036907e-1f;
+	}
+	else {
+		p = 4.2163199048e-2f;
+		p = p * z + 2.4181311049e-2f;
+		p = p * z + 4.5470025998e-2f;
+		p = p * z + 7.4953002686e-2f;
+		p = p * z + 1.6666752422e-1f;
+	}
+	p = p * z * s + s;
+	p = select(big, 1.57079632679f - 2.0f * p, p);
+	return select(x < 0.0f, -p, p);
+}
+
+//=======================================
+// Math policies
+//=======================================
+
+// Applies a scalar function to each lane in turn
+template <float (*F)(float)>
+inline float lanewise(float x) {
+	return F(x);
+}
+
+#if ! GALOIS_SIMD_SCALAR
+template <float (*F)(float)>
+inline vfloat lanewise(vfloat x) {
+	float lanes[VLANES];
+	vstore(lanes, x);
+	for (int i = 0; i < VLANES; ++i) {
+		lanes[i] = F(lanes[i]);
+	}
+	return vload(lanes);
+}
+#endif
+
+inline float std_sin(float x) { return std::sin(x); }
+inline float std_cos(float x) { return std::cos(x); }
+inline float std_tanh(float x) { return std::tanh(x); }
+inline float std_sinh(float x) { return std::sinh(x); }
+inline float std_asin(float x) { return std::asin(x); }
+inline float std_floor(float x) { return std::floor(x); }
+
+struct StdMath {
+	static const int tier = MATH_EXACT;
+
+	template <typename T> static T sin(T x) { return lanewise<std_sin>(x); }
+	template <typename T> static T cos(T x) { return lanewise<std_cos>(x); }
+	template <typename T> static T tanh(T x) { return lanewise<std_tanh>(x); }
+	template <typename T> static T sinh(T x) { return lanewise<std_sinh>(x); }
+	template <typename T> static T asin(T x) { return lanewise<std_asin>(x); }
+	template <typename T> static T floor(T x) { return lanewise<std_floor>(x); }
+
+	static float pow(float x, float y) { return std::pow(x, y); }
+#if ! GALOIS_SIMD_SCALAR
+	static vfloat pow(vfloat x, float y) {
+		float lanes[VLANES];
+		vstore(lanes, x);
+		for (int i = 0; i < VLANES; ++i) {
+			lanes[i] = std::pow(lanes[i], y);
+		}
+		return vload(lanes);
+	}
+#endif
+};
+
+template <int TIER>
+struct PolyMath {
+	static const int tier = TIER;
+
+	template <typename T> static T sin(T x) { return vm_sin<TIER>(x); }
+	template <typename T> static T cos(T x) { return vm_cos<TIER>(x); }
+	template <typename T> static T tanh(T x) { return vm_tanh<TIER>(x); }
+	template <typename T> static T sinh(T x) { return vm_sinh<TIER>(x); }
+	template <typename T> static T asin(T x) { return vm_asin<TIER>(x); }
+	template <typename T> static T floor(T x) { return vm_floor(x); }
+	template <typename T> static T pow(T x, float y) { return vm_pow<TIER>(x, T(y)); }
+};
+
+typedef PolyMath<MATH_PRECISE> VecMath;
+typedef PolyMath<MATH_FAST> FastMath;
@@ -0,0 +1,264 @@
+/*
+    Runtime instrumentation, off until setEnabled(true). While it is on, the
+    audio thread times each stage of the chain and the whole block, checks
+    the signal for NaNs, infinities and denormals, and keeps the slowest
+    block against its real-time budget. Whichever thread rebuilds the
+    parameter snapshot times each rebuild and counts the points of the
+    compiled curve that the chain's NaN check zeroed. Off, it costs a load
+    per block. On, the clock reads and checks add a little to the stages
+    they fall in: the remapper's input is checked in its stage, and the
+    output in the blend.
+
+    Each writer has a slot of counters to itself: processBlock() writes only
+    the block counters, and the rebuild, which runs under the snapshot lock,
+    only the rebuild counters. A counter is an atomic that its one writer
+    updates with a load and a store, so no writer or reader ever waits, and
+    any thread may call getReport(). A report is not taken at one instant:
+    its counters may come from neighbouring blocks.
+
+    Times are in ticks of std::chrono::steady_clock.
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdint.h>
+
+// The stages processChain() times
+enum {
+    STAGE_HOLD,     // Sample-and-hold and input gain
+    STAGE_FILTER,   // The filter, before or after the remapper
+    STAGE_REMAP,    // The remapper, with oversampling and antialiasing
+    STAGE_BLEND,    // Dry blend and output level
+    NUM_STAGES
+};
+
+const char* const STAGE_NAMES[NUM_STAGES] = { "hold", "filter", "remap", "blend" };
+
+// A copy of the counters since the last reset
+struct InstrumentationReport {
+    bool enabled = false;
+    double ticks_per_second = 0;
+
+    int64_t blocks = 0;
+    int64_t samples = 0;                    // Per channel
+    int64_t block_ticks = 0;                // Whole blocks, fast paths and all
+    int64_t stage_ticks[NUM_STAGES] = {};
+    int64_t worst_block_ticks = 0;
+    double worst_block_load = 0;            // The slowest block's time over its length in real time
+    int64_t overruns = 0;                   // Blocks that took longer than their length
+
+    int64_t nan_samples = 0;                // NaN or infinite, at the input, the remapper's input or the output
+    int64_t denormal_samples = 0;
+
+    int64_t rebuilds = 0;
+    int64_t rebuild_ticks = 0;
+    int64_t worst_rebuild_ticks = 0;
+    int64_t curve_nan_points = 0;           // In the last compiled curve
+};
+
+class Instrumentation
+{
+public:
+    // Any thread
+    void setEnabled(bool on) {
+        enabled.store(on, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    // Any thread: each writer zeroes its own counters when it next runs
+    void reset() {
+        block_reset.store(true, std::memory_order_relaxed);
+        rebuild_reset.store(true, std::memory_order_relaxed);
+    }
+
+    // Any thread
+    InstrumentationReport getReport() const {
+        InstrumentationReport r;
+        r.enabled = isEnabled();
+        r.ticks_per_second = TICKS_PER_SECOND;
+        r.blocks = blocks.load(std::memory_order_relaxed);
+        r.samples = samples.load(std::memory_order_relaxed);
+        r.block_ticks = block_ticks.load(std::memory_order_relaxed);
+        for (int s = 0; s < NUM_STAGES; ++s) {
+            r.stage_ticks[s] = stage_ticks[s].load(std::memory_order_relaxed);
+        }
+        r.worst_block_ticks = worst_block_ticks.load(std::memory_order_relaxed);
+        r.worst_block_load = worst_block_load.load(std::memory_order_relaxed);
+        r.overruns = overruns.load(std::memory_order_relaxed);
+        r.nan_samples = nan_samples.load(std::memory_order_relaxed);
+        r.denormal_samples = denormal_samples.load(std::memory_order_relaxed);
+        r.rebuilds = rebuilds.load(std::memory_order_relaxed);
+        r.rebuild_ticks = rebuild_ticks.load(std::memory_order_relaxed);
+        r.worst_rebuild_ticks = worst_rebuild_ticks.load(std::memory_order_relaxed);
+        r.curve_nan_points = curve_nan_points.load(std::memory_order_relaxed);
+        return r;
+    }
+
+    //==============================================================================
+    // Audio thread. Everything between beginBlock() and endBlock() does
+    // nothing unless the block is being measured.
+
+    void beginBlock() {
+        measuring = isEnabled();
+        if (!measuring) {
+            return;
+        }
+        if (block_reset.load(std::memory_order_relaxed)) {
+            block_reset.store(false, std::memory_order_relaxed);
+            zero(blocks); zero(samples); zero(block_ticks);
+            for (int s = 0; s < NUM_STAGES; ++s) {
+                zero(stage_ticks[s]);
+            }
+            zero(worst_block_ticks); zero(overruns); zero(nan_samples); zero(denormal_samples);
+            worst_block_load.store(0, std::memory_order_relaxed);
+        }
+        for (int s = 0; s < NUM_STAGES; ++s) {
+            block_stage_ticks[s] = 0;
+        }
+        block_nan_samples = 0;
+        block_denormal_samples = 0;
+        block_start = now();
+    }
+
+    // The time to pass to the first lap()
+    int64_t start() const {
+        return measuring ? now() : 0;
+    }
+
+    // Charges the time since since to stage, and returns the time now
+    int64_t lap(int stage, int64_t since) {
+        if (!measuring) {
+            return 0;
+        }
+        int64_t t = now();
+        block_stage_ticks[stage] += t - since;
+        return t;
+    }
+
+    // Counts NaNs, infinities and denormals in x
+    template <typename S>
+    void check(const S* x, int n) {
+        if (!measuring) {
+            return;
+        }
+        // Without branches, so that the loop vectorises
+        int nans = 0, denormals = 0;
+        for (int i = 0; i < n; ++i) {
+            S a = std::fabs(x[i]);
+            nans += !(a <= std::numeric_limits<S>::max());
+            denormals += (a < std::numeric_limits<S>::min()) & (a != 0);
+        }
+        block_nan_samples += nans;
+        block_denormal_samples += denormals;
+    }
+
+    void endBlock(int num_samples, double sample_rate) {
+        if (!measuring) {
+            return;
+        }
+        int64_t ticks = now() - block_start;
+        add(blocks, 1);
+        add(samples, num_samples);
+        add(block_ticks, ticks);
+        for (int s = 0; s < NUM_STAGES; ++s) {
+            add(stage_ticks[s], block_stage_ticks[s]);
+        }
+        add(nan_samples, block_nan_samples);
+        add(denormal_samples, block_denormal_samples);
+
+        // The block has as long as it lasts in real time
+        double budget = num_samples / sample_rate * TICKS_PER_SECOND;
+        double load = budget > 0 ? ticks / budget : 0;
+        if (load > 1) {
+            add(overruns, 1);
+        }
+        if (ticks > worst_block_ticks.load(std::memory_order_relaxed)) {
+            worst_block_ticks.store(ticks, std::memory_order_relaxed);
+        }
+        if (load > worst_block_load.load(std::memory_order_relaxed)) {
+            worst_block_load.store(load, std::memory_order_relaxed);
+        }
+        measuring = false;
+    }
+
+    //==============================================================================
+    // The thread rebuilding the snapshot, under the snapshot lock
+
+    int64_t beginRebuild() {
+        if (!isEnabled()) {
+            return -1;
+        }
+        if (rebuild_reset.load(std::memory_order_relaxed)) {
+            rebuild_reset.store(false, std::memory_order_relaxed);
+            zero(rebuilds); zero(rebuild_ticks); zero(worst_rebuild_ticks);
+        }
+        return now();
+    }
+
+    // started is what beginRebuild() returned
+    void endRebuild(int64_t started) {
+        if (started < 0) {
+            return;
+        }
+        int64_t ticks = now() - started;
+        add(rebuilds, 1);
+        add(rebuild_ticks, ticks);
+        if (ticks > worst_rebuild_ticks.load(std::memory_order_relaxed)) {
+            worst_rebuild_ticks.store(ticks, std::memory_order_relaxed);
+        }
+    }
+
+    // Whenever a curve is compiled, instrumented or not
+    void setCurveNanPoints(int points) {
+        curve_nan_points.store(points, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr double TICKS_PER_SECOND = (double)std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num;
+
+    static int64_t now() {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // Only the counter's one writer may call these
+    static void add(std::atomic<int64_t>& counter, int64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static void zero(std::atomic<int64_t>& counter) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> block_reset { false };
+    std::atomic<bool> rebuild_reset { false };
+
+    // Written by the audio thread
+    std::atomic<int64_t> blocks { 0 };
+    std::atomic<int64_t> samples { 0 };
+    std::atomic<int64_t> block_ticks { 0 };
+    std::atomic<int64_t> stage_ticks[NUM_STAGES] = {};
+    std::atomic<int64_t> worst_block_ticks { 0 };
+    std::atomic<double> worst_block_load { 0 };
+    std::atomic<int64_t> overruns { 0 };
+    std::atomic<int64_t> nan_samples { 0 };
+    std::atomic<int64_t> denormal_samples { 0 };
+
+    // The audio thread's totals for the block it is in
+    bool measuring = false;
+    int64_t block_start = 0;
+    int64_t block_stage_ticks[NUM_STAGES] = {};
+    int64_t block_nan_samples = 0;
+    int64_t block_denormal_samples = 0;
+
+    // Written by the rebuild
+    std::atomic<int64_t> rebuilds { 0 };
+    std::atomic<int64_t> rebuild_ticks { 0 };
+    std::atomic<int64_t> worst_rebuild_ticks { 0 };
+    std::atomic<int64_t> curve_nan_points { 0 };
+};
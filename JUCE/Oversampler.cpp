@@ -0,0 +1,379 @@
+/*
+	Polyphase half-band oversampling for the remapping stage. Each 2x stage
+	is a linear-phase half-band FIR, in which every other tap is zero apart
+	from the centre tap of 0.5. Split into its two polyphase branches, one
+	branch is a short FIR and the other a plain delay, so a stage costs one
+	half-length FIR per input sample in each direction. 4x and 8x cascade
+	further stages, each of which can be shorter than the last because the
+	band it has to reject starts further from the signal.
+*/
+#pragma once
+#include <math.h>
+#include "DspArena.cpp"
+
+#ifndef M_PI
+#define M_PI		3.14159265358979323846
+#endif
+
+/* oversampling factors, as stored in the "oversampling" parameter */
+enum {
+    OVERSAMPLING_1X,
+    OVERSAMPLING_2X,
+    OVERSAMPLING_4X,
+    OVERSAMPLING_8X
+};
+
+const int MAX_OVERSAMPLING_STAGES = 3;
+const int MAX_OVERSAMPLING_FACTOR = 1 << MAX_OVERSAMPLING_STAGES;
+// The most oversampled-rate samples the remapper may delay its output by (second order ADAA)
+const int MAX_REMAP_DELAY = 1;
+
+// Non-zero taps in the FIR branch of each stage, outermost first. Each must be a multiple of 4.
+const int HALF_BAND_TAPS[MAX_OVERSAMPLING_STAGES] = { 48, 12, 8 };
+
+/*
+	A history of the last `length` samples, stored twice over so that the
+	whole window can always be read as one contiguous run, oldest first.
+*/
+template <typename T>
+class SampleHistory
+{
+public:
+    void prepare(DspArena& arena, int new_length) {
+        length = new_length;
+        buffer = arena.allocate<T>(2 * length);
+        reset();
+    }
+
+    void reset() {
+        for (int i = 0; i < 2 * length; ++i) {
+            buffer[i] = 0;
+        }
+        pos = 0;
+    }
+
+    void push(T sample) {
+        buffer[pos] = sample;
+        buffer[pos + length] = sample;
+        pos = pos + 1 == length ? 0 : pos + 1;
+    }
+
+    const T* window() const {
+        return buffer + pos;
+    }
+
+    T oldest() const {
+        return buffer[pos];
+    }
+
+    // Takes over the contents of a history of the same length
+    void copyFrom(const SampleHistory& other) {
+        for (int i = 0; i < 2 * length; ++i) {
+            buffer[i] = other.buffer[i];
+        }
+        pos = other.pos;
+    }
+
+private:
+    T* buffer = 0;
+    int length = 0;
+    int pos = 0;
+};
+
+/*
+    One 2x stage for one channel. Each direction keeps the last few inputs
+    at the front of a linear buffer and appends the new block after them,
+    so every output's FIR window is one contiguous run of samples.
+*/
+class HalfBandStage
+{
+public:
+    // max_block is the most input samples upsample() will be given at once
+    void prepare(DspArena& arena, int num_taps, int max_block) {
+        taps = num_taps;
+        coefficients = arena.allocate<float>(taps);
+        design();
+        up_buffer = arena.allocate<float>(taps - 1 + max_block);
+        down_even = arena.allocate<float>(taps - 1 + max_block);
+        down_odd = arena.allocate<float>(taps / 2 + max_block);
+        reset();
+    }
+
+    void reset() {
+        for (int i = 0; i < taps - 1; ++i) {
+            up_buffer[i] = 0;
+            down_even[i] = 0;
+        }
+        for (int i = 0; i < taps / 2; ++i) {
+            down_odd[i] = 0;
+        }
+    }
+
+    // Takes over the history of the same stage on another channel
+    void copyFrom(const HalfBandStage& other) {
+        for (int i = 0; i < taps - 1; ++i) {
+            up_buffer[i] = other.up_buffer[i];
+            down_even[i] = other.down_even[i];
+        }
+        for (int i = 0; i < taps / 2; ++i) {
+            down_odd[i] = other.down_odd[i];
+        }
+    }
+
+    // out must hold 2 * n samples, and may be the same buffer as in
+    void upsample(const float* in, float* out, int n) {
+        float* history = up_buffer + taps - 1;
+        for (int i = 0; i < n; ++i) {
+            history[i] = in[i];
+        }
+        for (int i = 0; i < n; ++i) {
+            out[2 * i] = 2 * fir(up_buffer + i);
+            out[2 * i + 1] = up_buffer[i + taps / 2];
+        }
+        keep_last(up_buffer, taps - 1, n);
+    }
+
+    // in holds 2 * n samples, and may be the same buffer as out
+    void downsample(const float* in, float* out, int n) {
+        float* even = down_even + taps - 1;
+        float* odd = down_odd + taps / 2;
+        for (int i = 0; i < n; ++i) {
+            even[i] = in[2 * i];
+            odd[i] = in[2 * i + 1];
+        }
+        for (int i = 0; i < n; ++i) {
+            out[i] = fir(down_even + i) + 0.5f * down_odd[i];
+        }
+        keep_last(down_even, taps - 1, n);
+        keep_last(down_odd, taps / 2, n);
+    }
+
+private:
+    int taps = 0;
+    float* coefficients = 0;
+    float* up_buffer = 0;
+    float* down_even = 0;
+    float* down_odd = 0;
+
+    // Moves the last `keep` samples of a buffer holding keep + n to the front
+    static void keep_last(float* buffer, int keep, int n) {
+        for (int i = 0; i < keep; ++i) {
+            buffer[i] = buffer[n + i];
+        }
+    }
+
+    // Four independent sums, so the adds do not wait on each other. taps is a multiple of 4.
+    float fir(const float* window) const {
+        float sum[4] = { 0, 0, 0, 0 };
+        for (int k = 0; k < taps; k += 4) {
+            sum[0] += coefficients[k] * window[k];
+            sum[1] += coefficients[k + 1] * window[k + 1];
+            sum[2] += coefficients[k + 2] * window[k + 2];
+            sum[3] += coefficients[k + 3] * window[k + 3];
+        }
+        return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+
+    // Kaiser-windowed sinc, normalised so that the FIR branch has a DC gain of 0.5
+    void design() {
+        const double beta = 8;
+        // The full filter has 2 * taps - 1 taps, and the FIR branch holds every other one
+        int half_length = taps - 1;
+        double sum = 0;
+        for (int k = 0; k < taps; ++k) {
+            double t = 2 * k - half_length;
+            double x = t / half_length;
+            double window = bessel_i0(beta * sqrt(1 - x * x)) / bessel_i0(beta);
+            coefficients[k] = (float)(sin(M_PI * t / 2) / (M_PI * t) * window);
+            sum += coefficients[k];
+        }
+        for (int k = 0; k < taps; ++k) {
+            coefficients[k] = (float)(coefficients[k] * 0.5 / sum);
+        }
+    }
+
+    static double bessel_i0(double x) {
+        double result = 1, term = 1;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2 * k)) * (x / (2 * k));
+            result += term;
+        }
+        return result;
+    }
+};
+
+class Oversampler
+{
+public:
+    /*
+        Lays out the filters in the arena for the largest factor, so that
+        changing factor never allocates. max_block is the most base-rate
+        samples upsample() and downsample() will be given at once.
+    */
+    void prepare(DspArena& arena, int channels, int max_block) {
+        num_channels = channels;
+        stages = arena.allocate<HalfBandStage>(num_channels * MAX_OVERSAMPLING_STAGES);
+        for (int c = 0; c < num_channels; ++c) {
+            for (int s = 0; s < MAX_OVERSAMPLING_STAGES; ++s) {
+                stages[c * MAX_OVERSAMPLING_STAGES + s].prepare(arena, HALF_BAND_TAPS[s], max_block << s);
+            }
+        }
+        align_delay = arena.allocate<SampleHistory<float>>(num_channels);
+        for (int c = 0; c < num_channels; ++c) {
+            align_delay[c].prepare(arena, MAX_OVERSAMPLING_FACTOR);
+        }
+        dry_delay_length = 1;
+        for (int f = OVERSAMPLING_1X; f <= OVERSAMPLING_8X; ++f) {
+            if (getLatencySamples(f, MAX_REMAP_DELAY) >= dry_delay_length) {
+                dry_delay_length = getLatencySamples(f, MAX_REMAP_DELAY) + 1;
+            }
+        }
+        dry_delay = arena.allocate<SampleHistory<double>>(num_channels);
+        for (int c = 0; c < num_channels; ++c) {
+            dry_delay[c].prepare(arena, dry_delay_length);
+        }
+        num_stages = 0;
+    }
+
+    /*
+        remap_delay is how many samples, at the oversampled rate, whatever
+        runs between upsample() and downsample() delays its output by. It is
+        counted in the latency, and changing it alone keeps the histories.
+    */
+    void setFactor(int oversampling, int remap_delay) {
+        remap_samples = remap_delay;
+        if (oversampling == num_stages) {
+            return;
+        }
+        num_stages = oversampling;
+        for (int i = 0; i < num_channels * MAX_OVERSAMPLING_STAGES; ++i) {
+            stages[i].reset();
+        }
+        for (int c = 0; c < num_channels; ++c) {
+            align_delay[c].reset();
+            dry_delay[c].reset();
+        }
+    }
+
+    int getFactor() const {
+        return 1 << num_stages;
+    }
+
+    // out must hold getFactor() * n samples
+    void upsample(int channel, const float* in, float* out, int n) {
+        if (num_stages == 0) {
+            for (int i = 0; i < n; ++i) {
+                out[i] = in[i];
+            }
+            return;
+        }
+        HalfBandStage* channel_stages = stages + channel * MAX_OVERSAMPLING_STAGES;
+        channel_stages[0].upsample(in, out, n);
+        for (int s = 1; s < num_stages; ++s) {
+            n *= 2;
+            channel_stages[s].upsample(out, out, n);
+        }
+        n *= 2;
+        int padding = getAlignmentPadding(num_stages, remap_samples);
+        if (padding > 0) {
+            SampleHistory<float>& history = align_delay[channel];
+            for (int i = 0; i < n; ++i) {
+                history.push(out[i]);
+                out[i] = history.window()[MAX_OVERSAMPLING_FACTOR - 1 - padding];
+            }
+        }
+    }
+
+    // in holds getFactor() * n samples and is used as scratch space
+    void downsample(int channel, float* in, float* out, int n) {
+        if (num_stages == 0) {
+            for (int i = 0; i < n; ++i) {
+                out[i] = in[i];
+            }
+            return;
+        }
+        HalfBandStage* channel_stages = stages + channel * MAX_OVERSAMPLING_STAGES;
+        int len = n << (num_stages - 1);
+        for (int s = num_stages - 1; s > 0; --s) {
+            channel_stages[s].downsample(in, in, len);
+            len /= 2;
+        }
+        channel_stages[0].downsample(in, out, n);
+    }
+
+    // Delays a base-rate signal by the current latency, for paths that bypass the oversampler
+    float delay(int channel, float sample) {
+        SampleHistory<double>& history = dry_delay[channel];
+        history.push(sample);
+        return (float)history.window()[dry_delay_length - 1 - getLatencySamples(num_stages, remap_samples)];
+    }
+
+    // delay() over a run of float or double samples, in place
+    template <typename S>
+    void delay(int channel, S* samples, int n) {
+        SampleHistory<double>& history = dry_delay[channel];
+        int tap = dry_delay_length - 1 - getLatencySamples(num_stages, remap_samples);
+        for (int i = 0; i < n; ++i) {
+            history.push(samples[i]);
+            samples[i] = (S)history.window()[tap];
+        }
+    }
+
+    // Gives one channel another's filter histories and dry delay
+    void copyChannel(int from, int to) {
+        for (int s = 0; s < MAX_OVERSAMPLING_STAGES; ++s) {
+            stages[to * MAX_OVERSAMPLING_STAGES + s].copyFrom(stages[from * MAX_OVERSAMPLING_STAGES + s]);
+        }
+        align_delay[to].copyFrom(align_delay[from]);
+        dry_delay[to].copyFrom(dry_delay[from]);
+    }
+
+    // The group delay of the whole up/down chain, in samples at the base rate
+    static int getLatencySamples(int oversampling, int remap_delay) {
+        return (getStageLatency(oversampling) + remap_delay + getAlignmentPadding(oversampling, remap_delay)) >> oversampling;
+    }
+
+    /*
+        Base-rate samples after which a constant input gives a constant
+        output: each stage's histories span at most its taps at its own
+        rate in each direction, and the dry path is delayed by the latency.
+    */
+    static int getSettlingSamples(int oversampling, int remap_delay) {
+        int samples = getLatencySamples(oversampling, remap_delay) + 1;
+        for (int s = 0; s < oversampling; ++s) {
+            samples += 2 * ((HALF_BAND_TAPS[s] + (1 << s) - 1) >> s);
+        }
+        return samples;
+    }
+
+private:
+    int num_channels = 0;
+    int num_stages = 0;
+    HalfBandStage* stages = 0;
+    SampleHistory<float>* align_delay = 0;
+    // In double, so that it passes either sample type through unchanged
+    SampleHistory<double>* dry_delay = 0;
+    int dry_delay_length = 1;
+    int remap_samples = 0;
+
+    /*
+        Each stage delays by taps - 1 samples at its input rate, half on the
+        way up and half on the way down. This is the sum over all stages, in
+        samples at the oversampled rate. Below the outermost stage it is not
+        a whole number of base-rate samples, so upsample() pads it, along with
+        the remap delay, out at the oversampled rate and the dry path can be
+        delayed to match exactly.
+    */
+    static int getStageLatency(int oversampling) {
+        int latency = 0;
+        for (int s = 0; s < oversampling; ++s) {
+            latency += (HALF_BAND_TAPS[s] - 1) << (oversampling - s);
+        }
+        return latency;
+    }
+
+    static int getAlignmentPadding(int oversampling, int remap_delay) {
+        int factor = 1 << oversampling;
+        return (factor - (getStageLatency(oversampling) + remap_delay) % factor) % factor;
+    }
+};
@@ -1,503 +1,1026 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-#include "Waveform.cpp"
-#include <cmath>
-
-//==============================================================================
-Proto_galoisAudioProcessor::Proto_galoisAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-    : AudioProcessor(BusesProperties()
-        .withInput("Input", juce::AudioChannelSet::stereo(), true)
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true)
-    )
-#endif
-    , tree(*this, nullptr, "Galois_Parameter_Tree",
-        {
-            std::make_unique<juce::AudioParameterFloat>("bit_depth", "Bit Crush", juce::NormalisableRange<float>(2, MAX_BIT_DEPTH), 2),
-            std::make_unique<juce::AudioParameterInt>("sample_rate", "S & H", 1, 256, 1),
-            std::make_unique<juce::AudioParameterFloat>("output_level", "Output Level", juce::NormalisableRange<float>(0, 4), 1),
-            std::make_unique<juce::AudioParameterFloat>("input_level", "Input Level", juce::NormalisableRange<float>(0, 4), 1),
-            std::make_unique<juce::AudioParameterInt>("wf_base_wave", "Waveform", 0, NUM_WFs - 1, 0),
-            std::make_unique<juce::AudioParameterFloat>("wf_power", "Power", juce::NormalisableRange<float>(-1, 1), 0),
-            std::make_unique<juce::AudioParameterFloat>("wf_fold", "Fold", juce::NormalisableRange<float>(-9, 9), 0),
-            std::make_unique<juce::AudioParameterFloat>("wf_harm_freq", "Harm Freq", juce::NormalisableRange<float>(1, 40), 1),
-            std::make_unique<juce::AudioParameterFloat>("wf_harm_amp", "Harm Amount", juce::NormalisableRange<float>(-10, 10), 0),
-            std::make_unique<juce::AudioParameterFloat>("dry_blend", "Dry Blend", juce::NormalisableRange<float>(-1, 1), 0),
-            std::make_unique<juce::AudioParameterInt>("dry_blend_mode", "Blend Mode", 0, 4, 0),
-            std::make_unique<juce::AudioParameterInt>("bit_mask", "Bit Mask", -1023, 1023, 0),
-            std::make_unique<juce::AudioParameterFloat>("filter_blend", "Blend", 0.0f, 1.0f, 0.0f),
-            std::make_unique<juce::AudioParameterInt>("filter_pre", "Filter Before Remapping", 0, 1, 1),
-            std::make_unique<juce::AudioParameterFloat>("biquad_cutoff", "Cutoff", 0.0f, 9.0f, 9.0f),
-            std::make_unique<juce::AudioParameterFloat>("biquad_q", "Q", 0.0f, 1.0f, 0.5f),
-            std::make_unique<juce::AudioParameterFloat>("biquad_gain", "Filter Gain", 0.0f, 20.0f, 1.0f),
-            std::make_unique<juce::AudioParameterInt>("algorithm", "Algorithm", 0, 119, 0),
-        }
-    )
-{
-
-    sample_reduction_register = 0;
-    sample_reduction_counter = 0;
-
-    biquad_filter = 0;
-    biquad_position_names = new juce::String[2];
-    biquad_position_names[0] = "PRE";
-    biquad_position_names[1] = "POST";
-    biquad_type_names = new juce::String[3];
-    biquad_type_names[0] = "LP";
-    biquad_type_names[1] = "HP";
-    biquad_type_names[2] = "BP";
-    cached_biquad_type = 0;
-
-    
-    preset_names = new juce::String[NUM_PROGRAMMES];
-    preset_names[0] = "Init";
-    preset_names[1] = "Bad Radio";
-    preset_names[2] = "Cavernous Ringing";
-    preset_names[3] = "Clean Octave Up";
-    preset_names[4] = "Clean Transformer Splatter";
-    preset_names[5] = "Dirty Wavefolder";
-    preset_names[6] = "Dynamic Fuzz";
-    preset_names[7] = "Eight Bit Chomp";
-    preset_names[8] = "Fizzy Crunch";
-    preset_names[9] = "Gated Square";
-    preset_names[10] = "Green Ringer";
-    preset_names[11] = "Harmonic Croaker";
-    preset_names[12] = "Lazer Octave";
-    preset_names[13] = "Light Splatter";
-    preset_names[14] = "Medium Overdrive";
-    preset_names[15] = "Midrange Honk";
-    preset_names[16] = "Modem";
-    preset_names[17] = "Octave Fuzz";
-    preset_names[18] = "Passive Transformer";
-    preset_names[19] = "Purring Logic Gates";
-    preset_names[20] = "Throaty Crunch";
-    preset_filenames = new juce::String[NUM_PROGRAMMES];
-    preset_filenames[0] = "preset_Init_xml";
-    preset_filenames[1] = "preset_BadRadio_xml";
-    preset_filenames[2] = "preset_CarvernousRinging_xml";
-    preset_filenames[3] = "preset_CleanOctaveUp_xml";
-    preset_filenames[4] = "preset_CleanTransformerSplatter_xml";
-    preset_filenames[5] = "preset_DirtyFolder_xml";
-    preset_filenames[6] = "preset_DynamicFuzz_xml";
-    preset_filenames[7] = "preset_EightBitChomp_xml";
-    preset_filenames[8] = "preset_FizzyCrunch_xml";
-    preset_filenames[9] = "preset_GatedSquare_xml";
-    preset_filenames[10] = "preset_GreenRinger_xml";
-    preset_filenames[11] = "preset_HarmonicCroaker_xml";
-    preset_filenames[12] = "preset_LazerOctave_xml";
-    preset_filenames[13] = "preset_LightSplatter_xml";
-    preset_filenames[14] = "preset_MediumOverdrive_xml";
-    preset_filenames[15] = "preset_MidrangeHonk_xml";
-    preset_filenames[16] = "preset_Modem_xml";
-    preset_filenames[17] = "preset_OctaveFuzz_xml";
-    preset_filenames[18] = "preset_PassiveTransformer_xml";
-    preset_filenames[19] = "preset_PurringLogicGates_xml";
-    preset_filenames[20] = "preset_ThroatyCrunch_xml";
-    current_programme = 0;
-
-    generate_algorithms();
-
-    initialize_waveforms();
-    waveform_cache = new float[waveform_resolution];
-    cacheWaveforms();
-
-    tree.addParameterListener("bit_depth", this);
-    tree.addParameterListener("wf_base_wave", this);
-    tree.addParameterListener("wf_power", this);
-    tree.addParameterListener("wf_fold", this);
-    tree.addParameterListener("wf_harm_freq", this);
-    tree.addParameterListener("wf_harm_amp", this);
-    tree.addParameterListener("bit_mask", this);
-    tree.addParameterListener("sample_rate", this);
-    tree.addParameterListener("input_level", this);
-    tree.addParameterListener("output_level", this);
-    tree.addParameterListener("dry_blend", this);
-    tree.addParameterListener("filter_blend", this);
-    tree.addParameterListener("biquad_cutoff", this);
-    tree.addParameterListener("biquad_q", this);
-    tree.addParameterListener("biquad_gain", this);
-    tree.addParameterListener("algorithm", this);
-
-}
-
-
-Proto_galoisAudioProcessor::~Proto_galoisAudioProcessor()
-{
-    delete[] sample_reduction_register;
-    delete[] preset_filenames;
-    delete[] preset_names;
-    delete[] waveform_cache;
-}
-
-//==============================================================================
-const juce::String Proto_galoisAudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool Proto_galoisAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool Proto_galoisAudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool Proto_galoisAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double Proto_galoisAudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int Proto_galoisAudioProcessor::getNumPrograms()
-{
-    return NUM_PROGRAMMES;
-}
-
-int Proto_galoisAudioProcessor::getCurrentProgram()
-{
-    return current_programme;
-}
-
-void Proto_galoisAudioProcessor::setCurrentProgram (int index)
-{
-    if (index < 0 || index >= NUM_PROGRAMMES) {
-        return;
-    }
-    current_programme = index;
-    int dataSize = 0;
-    const char* xml = BinaryData::getNamedResource(preset_filenames[index].toRawUTF8(), dataSize);
-    std::unique_ptr<juce::XmlElement> xmlState = juce::XmlDocument(xml).getDocumentElement();
-
-    if (xmlState.get() != nullptr) {  
-        if (xmlState->hasTagName(tree.state.getType())) {
-            tree.replaceState(juce::ValueTree::fromXml(*xmlState));
-        }
-    }
-}
-
-const juce::String Proto_galoisAudioProcessor::getProgramName (int index)
-{
-    if (index < 0 || index >= NUM_PROGRAMMES) {
-        return "ERROR in value of index";
-    }
-    return preset_names[index];
-    return juce::String("");
-}
-
-void Proto_galoisAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
-
-//==============================================================================
-void Proto_galoisAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    host_sample_rate = sampleRate;
-    num_channels = getNumInputChannels();
-    sample_reduction_register = new float[num_channels];
-    biquad_filter = new Biquad[num_channels];
-    parameterChanged("", 0);
-    updateFilter();
-}
-
-void Proto_galoisAudioProcessor::releaseResources()
-{
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool Proto_galoisAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-float scale_sample(float s) {
-    if (abs(s) > 1) {
-        s *= 1.0f / (float)ceil(abs(s));
-    }
-    return s;
-}
-
-float Proto_galoisAudioProcessor::getWaveformValue(
-    float sample) {
-    return remap_sample(
-        sample,
-        cached_wf_base_wave,
-        cached_wf_power,
-        cached_wf_harm_freq,
-        cached_wf_harm_amp,
-        cached_bit_depth,
-        cached_wf_fold,
-        cached_bit_mask,
-        cached_algorithm
-    );
-}
-
-void Proto_galoisAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-
-    for (auto i = 0; i < num_channels; ++i){
-        float* channel = buffer.getWritePointer(i);
-        for (auto j = 0; j < buffer.getNumSamples(); ++j){
-            float sample = channel[j];
-
-            // Sample reduction
-            sample_reduction_counter++;
-            if (sample_reduction_counter >= cached_sample_rate) {
-                sample_reduction_counter = 0;
-                sample_reduction_register[i] = sample;
-            }
-            else {
-                sample = sample_reduction_register[i];
-            }
-            
-            // Input level
-            sample *= sqrt(cached_input_level);
-
-            // Filter
-            if (cached_filter_pre == 0) {
-                sample = apply_filter(sample, i);
-            }
-            // Waveform remapping
-            sample = getWaveformValue(sample);
-
-            // Filter
-            if (cached_filter_pre == 1) {
-                sample = apply_filter(sample, i);
-            }
-
-            // Dry Blend
-            sample = cached_dry_blend_sign * channel[j] * cached_dry_blend_abs + sample * (1 - cached_dry_blend_abs);
-            sample /= 2;
-
-            // Output Level             
-            sample *= cached_output_level;
-            sample *= 0.7;
-            // Clamp to valid range
-            sample = clamp(sample, -1, 1);
-            
-            channel[j] = sample;
-     
-        }
-    }
-}
-
-float Proto_galoisAudioProcessor::apply_filter(float sample, int channel) {
-    float filtered_sample = biquad_filter[channel].apply(sample);
-    sample = filtered_sample * (cached_filter_blend) + sample * (1 - cached_filter_blend);
-    sample /= 2;
-    return sample;
-}
-
-const char* Proto_galoisAudioProcessor::getWaveformName() {
-    int i = (int)*tree.getRawParameterValue("wf_base_wave");
-    return wf_names[i];
-
-}
-
-//==============================================================================
-bool Proto_galoisAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* Proto_galoisAudioProcessor::createEditor()
-{
-    return new Proto_galoisAudioProcessorEditor (*this, tree);
-}
-
-//==============================================================================
-void Proto_galoisAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    auto state = tree.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
-}
-
-void Proto_galoisAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-
-    if (xmlState.get() != nullptr) {
-        if (xmlState->hasTagName(tree.state.getType())) {
-            tree.replaceState(juce::ValueTree::fromXml(*xmlState));
-            current_programme = -1;
-        }
-    }
-}
-
-void Proto_galoisAudioProcessor::saveFactoryPreset(juce::String name) {
-    juce::ValueTree t = tree.copyState();
-    std::unique_ptr<juce::XmlElement> xml = t.createXml();
-    juce::File dir = juce::File::getSpecialLocation(juce::File::SpecialLocationType::userDocumentsDirectory);
-    juce::String fname = dir.getFullPathName();
-    fname.append("\\preset_", 9);
-    fname.append(name, 99);
-    fname.append(".xml", 4);
-    juce::File f = juce::File(fname);
-    xml->writeTo(f);
-}
-
-//==============================================================================
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new Proto_galoisAudioProcessor();
-}
-
-//==============================================================================
-// Cache the waveform here
-void Proto_galoisAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue) {
-    cacheWaveforms();
-    
-//    if (parameterID == "biquad_cutoff") {
-        cached_biquad_cutoff = 16 * pow(2, *tree.getRawParameterValue("biquad_cutoff"));
-        if (cached_biquad_cutoff >= host_sample_rate / 2) {
-            cached_biquad_cutoff = host_sample_rate / 2 - 1;
-        }
-//    } else if (parameterID == "biquad_q") {
-        cached_biquad_q = 1.01 - *tree.getRawParameterValue("biquad_q");
-//    } else if (parameterID == "biquad_gain") {
-        cached_biquad_gain = *tree.getRawParameterValue("biquad_gain");
-//    }
-
-//    if (parameterID.contains("biquad")) {
-        updateFilter();
-//    }
-}
-
-void Proto_galoisAudioProcessor::updateFilter() {
-    for (int i = 0; i < num_channels; ++i) {
-        biquad_filter[i].recalculate(
-            host_sample_rate,
-            cached_biquad_cutoff,
-            cached_biquad_q,
-            cached_biquad_gain,
-            cached_biquad_type
-            );
-    }
-}
-
-void Proto_galoisAudioProcessor::cacheWaveforms() {
-    cached_bit_depth = *tree.getRawParameterValue("bit_depth");
-    cached_sample_rate = *tree.getRawParameterValue("sample_rate");
-    cached_output_level = *tree.getRawParameterValue("output_level");
-    cached_output_level = pow(cached_output_level * ROOT_2, 2);
-    cached_input_level = *tree.getRawParameterValue("input_level");
-    cached_input_level = pow(cached_input_level * ROOT_2, 2);
-    cached_wf_base_wave = *tree.getRawParameterValue("wf_base_wave");
-    cached_wf_power = *tree.getRawParameterValue("wf_power");
-    cached_wf_fold = *tree.getRawParameterValue("wf_fold");
-    cached_wf_harm_freq = *tree.getRawParameterValue("wf_harm_freq");
-    cached_wf_harm_amp = *tree.getRawParameterValue("wf_harm_amp");
-    cached_dry_blend = *tree.getRawParameterValue("dry_blend");
-    cached_dry_blend_mode = *tree.getRawParameterValue("dry_blend_mode");
-    cached_dry_blend_abs = abs(*tree.getRawParameterValue("dry_blend"));
-    cached_dry_blend_sign = sgn(*tree.getRawParameterValue("dry_blend"));
-    cached_bit_mask = *tree.getRawParameterValue("bit_mask");
-    cached_filter_pre = *tree.getRawParameterValue("filter_pre");
-    cached_filter_blend= *tree.getRawParameterValue("filter_blend");
-    int algo = int(*tree.getRawParameterValue("algorithm"));
-    cached_algorithm = algorithms[algo];
-
-    float waveform_resolution_half = (float)waveform_resolution / 2;
-    for (int i = 0; i < waveform_resolution; i++) {
-        float amp = (float)(i - waveform_resolution_half) / waveform_resolution_half;
-        waveform_cache[i] = getWaveformValue(amp);
-    }
-}
-
-void Proto_galoisAudioProcessor::generate_algorithms() {
-    algorithms = new int* [120];
-    algorithms[0] = new int[5]{ 0, 1, 2, 3, 4 };
-    for (int i = 1; i < 120; ++i) {
-        algorithms[i] = new int[5];
-        for (int j = 0; j < 5; ++j) {
-            algorithms[i][j] = algorithms[i - 1][j];
-        }
-        std::next_permutation(algorithms[i], algorithms[i] + 5);
-    }
-}
-
-juce::String Proto_galoisAudioProcessor::getFilterPosition() {
-    int i = *tree.getRawParameterValue("filter_pre");
-    return biquad_position_names[i];
-}
-
-juce::String Proto_galoisAudioProcessor::getFilterType() {
-    return biquad_type_names[cached_biquad_type];
-}
-
-void Proto_galoisAudioProcessor::cycleParamValue(juce::String parameterID) {
-    if (parameterID == "biquad_type") {
-        int current = cached_biquad_type;
-        ++current;
-        if (current > 2) {
-            current = 0;
-        }
-        cached_biquad_type = current;
-        updateFilter();
-    }
-    else {
-        int current = *tree.getRawParameterValue(parameterID);
-        ++current;
-        if (current > (tree.getParameter(parameterID)->getNormalisableRange().end)) {
-            current = 0;
-        }
-        tree.getParameter(parameterID)->beginChangeGesture();
-        tree.getParameter(parameterID)->setValueNotifyingHost(current);
-        tree.getParameter(parameterID)->endChangeGesture();
-        parameterChanged(parameterID, current);
-    }
-}
-
-
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "Waveform.h"
+#include "TransferTableCache.cpp"
+#include "Adaa.cpp"
+#include "WaveformBlock.cpp"
+#include "RemapKernels.cpp"
+#include "Decimator.cpp"
+#include "BlockStages.cpp"
+#include <cmath>
+#include <cstring>
+
+// The integer engine ignores these (see FixedPoint.cpp), and hosts show them as inactive
+#if GALOIS_FIXED_POINT
+#define FLOAT_ENGINE_ONLY(name) name " (Inactive)"
+#else
+#define FLOAT_ENGINE_ONLY(name) name
+#endif
+
+//==============================================================================
+Proto_galoisAudioProcessor::Proto_galoisAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+    : AudioProcessor(BusesProperties()
+        .withInput("Input", juce::AudioChannelSet::stereo(), true)
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+    )
+#endif
+    , tree(*this, nullptr, STATE_TYPE,
+        {
+            std::make_unique<juce::AudioParameterFloat>("bit_depth", "Bit Crush", juce::NormalisableRange<float>(2, MAX_BIT_DEPTH), 2),
+            std::make_unique<juce::AudioParameterInt>("sample_rate", "S & H", 1, 256, 1),
+            std::make_unique<juce::AudioParameterInt>("hold_units", "S & H Units", HOLD_UNITS_SAMPLES, HOLD_UNITS_HZ, HOLD_UNITS_SAMPLES),
+            std::make_unique<juce::AudioParameterFloat>("hold_rate", "S & H Rate (Hz)", juce::NormalisableRange<float>(100.0f, 96000.0f, 0.0f, 0.3f), 48000.0f),
+            std::make_unique<juce::AudioParameterInt>("hold_step", "S & H Step", HOLD_STEP_PLAIN, HOLD_STEP_BAND_LIMITED, HOLD_STEP_PLAIN),
+            std::make_unique<juce::AudioParameterFloat>("output_level", "Output Level", juce::NormalisableRange<float>(0, 4), 1),
+            std::make_unique<juce::AudioParameterFloat>("input_level", "Input Level", juce::NormalisableRange<float>(0, 4), 1),
+            std::make_unique<juce::AudioParameterInt>("wf_base_wave", "Waveform", 0, NUM_WFs - 1, 0),
+            std::make_unique<juce::AudioParameterInt>("wf_morph_mode", FLOAT_ENGINE_ONLY("Morph Mode"), 0, 1, 0),
+            std::make_unique<juce::AudioParameterFloat>("wf_morph", FLOAT_ENGINE_ONLY("Morph"), juce::NormalisableRange<float>(0, NUM_WFs - 1), 0),
+            std::make_unique<juce::AudioParameterFloat>("wf_power", "Power", juce::NormalisableRange<float>(-1, 1), 0),
+            std::make_unique<juce::AudioParameterFloat>("wf_fold", "Fold", juce::NormalisableRange<float>(-9, 9), 0),
+            std::make_unique<juce::AudioParameterFloat>("wf_harm_freq", "Harm Freq", juce::NormalisableRange<float>(1, 40), 1),
+            std::make_unique<juce::AudioParameterFloat>("wf_harm_amp", "Harm Amount", juce::NormalisableRange<float>(-10, 10), 0),
+            std::make_unique<juce::AudioParameterFloat>("dry_blend", "Dry Blend", juce::NormalisableRange<float>(-1, 1), 0),
+            std::make_unique<juce::AudioParameterInt>("dry_blend_mode", "Blend Mode", 0, 4, 0),
+            std::make_unique<juce::AudioParameterInt>("bit_mask", "Bit Mask", -1023, 1023, 0),
+            std::make_unique<juce::AudioParameterFloat>("filter_blend", "Blend", 0.0f, 1.0f, 0.0f),
+            std::make_unique<juce::AudioParameterInt>("filter_pre", "Filter Before Remapping", 0, 1, 1),
+            std::make_unique<juce::AudioParameterFloat>("biquad_cutoff", "Cutoff", 0.0f, 9.0f, 9.0f),
+            std::make_unique<juce::AudioParameterFloat>("biquad_q", "Q", 0.0f, 1.0f, 0.5f),
+            std::make_unique<juce::AudioParameterFloat>("biquad_gain", "Filter Gain", 0.0f, 20.0f, 1.0f),
+            std::make_unique<juce::AudioParameterInt>("algorithm", "Algorithm", 0, 119, 0),
+            std::make_unique<juce::AudioParameterInt>("remap_engine", FLOAT_ENGINE_ONLY("Remap Engine"), REMAP_ENGINE_TABLE, REMAP_ENGINE_DIRECT, REMAP_ENGINE_TABLE),
+            std::make_unique<juce::AudioParameterInt>("oversampling", FLOAT_ENGINE_ONLY("Oversampling"), OVERSAMPLING_1X, OVERSAMPLING_8X, OVERSAMPLING_1X),
+            std::make_unique<juce::AudioParameterInt>("antialiasing", FLOAT_ENGINE_ONLY("Antialiasing"), ANTIALIASING_OFF, ANTIALIASING_ADAA2, ANTIALIASING_OFF),
+            std::make_unique<juce::AudioParameterInt>("math_accuracy", "Math Accuracy", MATH_EXACT, MATH_FAST, MATH_PRECISE),
+            std::make_unique<juce::AudioParameterFloat>("curve_ramp", "Curve Ramp (ms)", juce::NormalisableRange<float>(0, 200), 20),
+        }
+    )
+{
+
+    biquad_position_names = new juce::String[2];
+    biquad_position_names[0] = "PRE";
+    biquad_position_names[1] = "POST";
+    biquad_type_names = new juce::String[3];
+    biquad_type_names[0] = "LP";
+    biquad_type_names[1] = "HP";
+    biquad_type_names[2] = "BP";
+    cached_biquad_type = 0;
+
+    
+    current_programme = 0;
+
+    host_sample_rate = 44100;
+    num_channels = 0;
+    parameters_changed = false;
+    applying_values = false;
+    snapshot = 0;
+    snapshot_slot = -1;
+    current_table_index = 0;
+    previous_table_index = 0;
+    ramp_length = 0;
+    ramp_position = 0;
+    display_version = 0;
+    tail_samples = 0;
+    scalar_changes = 0;
+    for (int i = 0; i < NUM_SCALAR_PARAMETERS; ++i) {
+        scalar_values[i] = tree.getRawParameterValue(SCALAR_PARAMETER_IDS[i]);
+    }
+    cacheWaveforms();
+    // The audio thread starts on slot 0, which needs a table even on the direct engine
+    if (transfer_tables[0] == nullptr) {
+        transfer_tables[0] = TransferTableCache::getInstance().get(cached_remap_params);
+    }
+
+    tree.addParameterListener("bit_depth", this);
+    tree.addParameterListener("wf_base_wave", this);
+    tree.addParameterListener("wf_morph_mode", this);
+    tree.addParameterListener("wf_morph", this);
+    tree.addParameterListener("wf_power", this);
+    tree.addParameterListener("wf_fold", this);
+    tree.addParameterListener("wf_harm_freq", this);
+    tree.addParameterListener("wf_harm_amp", this);
+    tree.addParameterListener("bit_mask", this);
+    tree.addParameterListener("sample_rate", this);
+    tree.addParameterListener("hold_units", this);
+    tree.addParameterListener("hold_rate", this);
+    tree.addParameterListener("hold_step", this);
+    tree.addParameterListener("input_level", this);
+    tree.addParameterListener("output_level", this);
+    tree.addParameterListener("dry_blend", this);
+    tree.addParameterListener("filter_blend", this);
+    tree.addParameterListener("biquad_cutoff", this);
+    tree.addParameterListener("biquad_q", this);
+    tree.addParameterListener("biquad_gain", this);
+    tree.addParameterListener("algorithm", this);
+    tree.addParameterListener("remap_engine", this);
+    tree.addParameterListener("oversampling", this);
+    tree.addParameterListener("antialiasing", this);
+    tree.addParameterListener("math_accuracy", this);
+    tree.addParameterListener("curve_ramp", this);
+
+    startTimerHz(50);
+}
+
+
+Proto_galoisAudioProcessor::~Proto_galoisAudioProcessor()
+{
+    stopTimer();
+}
+
+//==============================================================================
+const juce::String Proto_galoisAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool Proto_galoisAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool Proto_galoisAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool Proto_galoisAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double Proto_galoisAudioProcessor::getTailLengthSeconds() const
+{
+    return tail_samples.load(std::memory_order_relaxed) / host_sample_rate;
+}
+
+int Proto_galoisAudioProcessor::getNumPrograms()
+{
+    return NUM_PROGRAMMES;
+}
+
+int Proto_galoisAudioProcessor::getCurrentProgram()
+{
+    return current_programme;
+}
+
+void Proto_galoisAudioProcessor::setCurrentProgram (int index)
+{
+    if (index < 0 || index >= NUM_PROGRAMMES) {
+        return;
+    }
+    current_programme = index;
+    applyParameterValues(FactoryPresetBank::getInstance(getDefaultValues()).getValues(index));
+}
+
+const juce::String Proto_galoisAudioProcessor::getProgramName (int index)
+{
+    if (index < 0 || index >= NUM_PROGRAMMES) {
+        return "ERROR in value of index";
+    }
+    return FACTORY_PRESETS[index].name;
+    return juce::String("");
+}
+
+void Proto_galoisAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void Proto_galoisAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    host_sample_rate = sampleRate;
+    num_channels = getNumInputChannels();
+
+    // The second pass only happens when the arena had to grow
+    arena.begin();
+    allocateChannelState();
+    if (!arena.fits()) {
+        arena.grow();
+        arena.begin();
+        allocateChannelState();
+    }
+    cacheWaveforms();
+    snapshot_slot = -1;
+    acquireSnapshot();
+
+    // Start on the active curve rather than fading in to it
+    ramp_position = ramp_length = 0;
+    beginCurveRamp();
+    ramp_position = ramp_length;
+    current_morph = snapshot->wf_morph;
+}
+
+// Lays out everything the audio thread keeps per channel in the arena, zeroed
+void Proto_galoisAudioProcessor::allocateChannelState() {
+    channels.hold = arena.allocate<DecimatorState>(num_channels);
+    channels.filter = arena.allocate<Biquad::State>(num_channels);
+    channels.adaa = arena.allocate<AdaaState>(num_channels);
+    channels.steady = arena.allocate<SteadyInput>(num_channels);
+    channels.identical_run = arena.allocate<int>(num_channels);
+    // Every channel starts from the same state, so any can repeat the first
+    channels.mirrored = arena.allocate<bool>(num_channels);
+    for (int i = 1; i < num_channels; ++i) {
+        channels.mirrored[i] = true;
+    }
+#if GALOIS_FIXED_POINT
+    channels.fixed_hold = arena.allocate<q27>(num_channels);
+    channels.fixed_hold_counter = arena.allocate<int>(num_channels);
+    channels.fixed_filter = arena.allocate<FixedBiquad>(num_channels);
+#endif
+    oversampler.prepare(arena, num_channels, REMAP_BLOCK_SIZE);
+}
+
+// For a channel that stops repeating another, whose state has stood in for its own
+void Proto_galoisAudioProcessor::copyChannelState(int from, int to) {
+    channels.hold[to] = channels.hold[from];
+    channels.filter[to] = channels.filter[from];
+    channels.adaa[to] = channels.adaa[from];
+    channels.steady[to] = channels.steady[from];
+    oversampler.copyChannel(from, to);
+}
+
+void Proto_galoisAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool Proto_galoisAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // Every channel is processed the same way, so any discrete or surround
+    // layout will do, from mono up to 7.1.4 and beyond.
+    if (layouts.getMainOutputChannelSet().isDisabled())
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+float scale_sample(float s) {
+    if (abs(s) > 1) {
+        s *= 1.0f / (float)ceil(abs(s));
+    }
+    return s;
+}
+
+void Proto_galoisAudioProcessor::remapBlock(const TransferTable& table, const RemapParams& params, AdaaState& state, const float* in, float* out, int n, float morph_from, float morph_to) {
+    // The bank has no antiderivatives, so morphing bypasses antialiasing
+    if (params.morph) {
+        float step = (morph_to - morph_from) / n;
+        for (int i = 0; i < n; ++i) {
+            out[i] = table.lookupMorph(in[i], morph_from + step * (i + 1));
+        }
+        return;
+    }
+    // Antialiasing needs the antiderivatives in the transfer table, whichever engine is selected
+    if (snapshot->antialiasing == ANTIALIASING_ADAA1) {
+        for (int i = 0; i < n; ++i) {
+            out[i] = adaa1(table, state, in[i]);
+        }
+        return;
+    }
+    if (snapshot->antialiasing == ANTIALIASING_ADAA2) {
+        for (int i = 0; i < n; ++i) {
+            out[i] = adaa2(table, state, in[i]);
+        }
+        return;
+    }
+    if (snapshot->remap_engine == REMAP_ENGINE_DIRECT) {
+        // Only the default tier has fused kernels; the others run stage by stage
+        switch (params.math_tier) {
+        case MATH_EXACT:
+            remap_block<StdMath>(in, out, n, params);
+            break;
+        case MATH_PRECISE:
+            get_remap_kernel<VecMath>(params.algorithm, params.wf)(in, out, n, StageConstants(params));
+            break;
+        default:
+            remap_block<FastMath>(in, out, n, params);
+            break;
+        }
+        return;
+    }
+    for (int i = 0; i < n; ++i) {
+        out[i] = table.lookup(in[i]);
+    }
+}
+
+// ramp_start is how far into the crossfade the block starts, in samples at the base rate
+void Proto_galoisAudioProcessor::getWaveformBlock(const float* in, float* out, int n, int channel, int ramp_start, float morph_from, float morph_to) {
+    const TransferTable& table = *transfer_tables[current_table_index];
+    if (ramp_start >= ramp_length) {
+        remapBlock(table, current_params, channels.adaa[channel], in, out, n, morph_from, morph_to);
+        return;
+    }
+
+    // The outgoing curve gets its own copy of the antialiasing history, whose
+    // cached difference belongs to the incoming curve
+    AdaaState fading_state = channels.adaa[channel];
+    fading_state.d1_valid = false;
+    float fading[REMAP_BLOCK_SIZE * MAX_OVERSAMPLING_FACTOR];
+    remapBlock(table, current_params, channels.adaa[channel], in, out, n, morph_from, morph_to);
+    remapBlock(*transfer_tables[previous_table_index], previous_params, fading_state, in, fading, n, morph_from, morph_to);
+
+    float step = 1.0f / ((float)ramp_length * oversampler.getFactor());
+    float gain = (float)ramp_start / ramp_length;
+    for (int i = 0; i < n; ++i) {
+        gain = juce::jmin(gain + step, 1.0f);
+        out[i] = fading[i] + gain * (out[i] - fading[i]);
+    }
+}
+
+void Proto_galoisAudioProcessor::beginCurveRamp() {
+    if (ramp_position < ramp_length) {
+        return;
+    }
+    // Move on to the active table, keeping the one it replaces for the crossfade
+    int active = transfer_tables.acquire(current_table_index);
+
+    bool table_based = snapshot->remap_engine == REMAP_ENGINE_TABLE || snapshot->antialiasing != ANTIALIASING_OFF || snapshot->remap_params.morph;
+    bool changed = table_based ? transfer_tables[active] != transfer_tables[current_table_index] : snapshot->remap_params != current_params;
+    previous_table_index = current_table_index;
+    previous_params = current_params;
+    current_table_index = active;
+    current_params = snapshot->remap_params;
+
+    ramp_length = (int)(snapshot->curve_ramp * 0.001 * host_sample_rate);
+    ramp_position = changed ? 0 : ramp_length;
+
+    // ADAA2's cached difference was taken on the old curve
+    if (changed) {
+        for (int i = 0; i < num_channels; ++i) {
+            channels.adaa[i].d1_valid = false;
+        }
+    }
+}
+
+void Proto_galoisAudioProcessor::acquireSnapshot() {
+    int slot = snapshots.acquire(-1);
+    snapshot = &live_snapshot;
+    bool published = slot != snapshot_slot;
+    if (published) {
+        snapshot_slot = slot;
+        live_snapshot = snapshots[slot];
+    }
+    // Scalar parameters changed since the snapshot was built are read here,
+    // which is cheap enough for every block that needs it
+    int changes = scalar_changes.load(std::memory_order_acquire);
+    bool rescaled = changes != live_snapshot.scalar_version;
+    if (rescaled) {
+        Biquad design;
+        readScalarParameters(live_snapshot, design);
+        live_snapshot.scalar_version = changes;
+    }
+    if (!published && !rescaled) {
+        return;
+    }
+    // The filters keep their state and take the new coefficients
+    biquad_filter.setCoefficients(snapshot->filter_coefficients, snapshot->filter_initialized);
+    // Constant input settles on a different output now
+    for (int i = 0; i < num_channels; ++i) {
+        channels.steady[i].run = 0;
+    }
+#if GALOIS_FIXED_POINT
+    for (int i = 0; i < num_channels; ++i) {
+        channels.fixed_filter[i].recalculate(snapshot->filter_coefficients, snapshot->filter_initialized);
+    }
+#endif
+}
+
+void Proto_galoisAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    instrumentation.beginBlock();
+
+    // Rendering offline can wait for the snapshot to be rebuilt, so that
+    // automation lands on the block it belongs to. That takes snapshot_lock
+    // and may compile tables, so offline rendering is not real-time safe,
+    // and RealtimeCheck.cpp leaves it out.
+    if (isNonRealtime()) {
+        timerCallback();
+    }
+    acquireSnapshot();
+
+#if GALOIS_FIXED_POINT
+    // The integer engine is timed as a whole
+    processBlockFixed(buffer);
+#else
+    processChain(buffer);
+#endif
+    instrumentation.endBlock(buffer.getNumSamples(), host_sample_rate);
+}
+
+void Proto_galoisAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    instrumentation.beginBlock();
+
+    if (isNonRealtime()) {
+        timerCallback();
+    }
+    acquireSnapshot();
+    processChain(buffer);
+    instrumentation.endBlock(buffer.getNumSamples(), host_sample_rate);
+}
+
+bool Proto_galoisAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    // The integer engine only takes float buffers
+    return !GALOIS_FIXED_POINT;
+}
+
+// The chain at the host's precision. Everything but the remapper runs in S.
+template <typename S>
+void Proto_galoisAudioProcessor::processChain(juce::AudioBuffer<S>& buffer)
+{
+    // The chain runs a stage at a time over sub-blocks, which keeps the
+    // oversampled buffers and the filter state in cache (see BlockStages.cpp)
+    S dry[MAX_FILTER_CHANNELS][REMAP_BLOCK_SIZE];
+    S scratch[REMAP_BLOCK_SIZE];
+    float converted[REMAP_BLOCK_SIZE];
+    float oversampled_in[REMAP_BLOCK_SIZE * MAX_OVERSAMPLING_FACTOR];
+    float oversampled_out[REMAP_BLOCK_SIZE * MAX_OVERSAMPLING_FACTOR];
+
+    oversampler.setFactor(snapshot->oversampling, snapshot->remap_delay);
+    beginCurveRamp();
+
+    // The morph position is swept across the block rather than jumping at its start
+    const int num_samples = buffer.getNumSamples();
+    float morph_step = (snapshot->wf_morph - current_morph) / juce::jmax(1, num_samples);
+    const bool curve_static = ramp_position >= ramp_length && morph_step == 0;
+
+    // The halvings after each blend are folded into its gains
+    const S filter_wet = (S)snapshot->filter_blend / 2;
+    const S filter_dry = (1 - (S)snapshot->filter_blend) / 2;
+    const S dry_gain = (S)snapshot->dry_blend_sign * (S)snapshot->dry_blend_abs / 2;
+    const S wet_gain = (1 - (S)snapshot->dry_blend_abs) / 2;
+    const S output_gain = (S)snapshot->output_level * (S)0.7;
+    const hold_time hold_period = to_hold_time(snapshot->hold_period);
+
+    /*
+        A channel whose input repeats the first channel's copies its output,
+        for as long as its state is the first channel's too. That holds from
+        the start, and again once identical input has outlasted the tail.
+        Every channel's hold runs at the same phase, so it settles as well.
+    */
+    const S* first = num_channels > 0 ? buffer.getReadPointer(0) : 0;
+    for (auto i = 1; i < num_channels; ++i) {
+        bool identical = std::memcmp(first, buffer.getReadPointer(i), sizeof(S) * num_samples) == 0;
+        if (!identical) {
+            // Picks up from where the first channel is before this block
+            if (channels.mirrored[i]) {
+                copyChannelState(0, i);
+            }
+            channels.mirrored[i] = false;
+            channels.identical_run[i] = 0;
+            continue;
+        }
+        channels.mirrored[i] = channels.mirrored[i] || channels.identical_run[i] >= snapshot->tail_samples;
+        channels.identical_run[i] = juce::jmin(channels.identical_run[i] + num_samples, MAX_STEADY_RUN);
+    }
+
+    /*
+        The channels that need the chain run through it together, in groups
+        of up to MAX_FILTER_CHANNELS, a stage at a time across the group, so
+        that the filter can run them in parallel.
+    */
+    int group[MAX_FILTER_CHANNELS];
+    S* x[MAX_FILTER_CHANNELS];
+    Biquad::State* filter_state[MAX_FILTER_CHANNELS];
+    for (auto next = 0; next < num_channels;) {
+        int group_size = 0;
+        for (; next < num_channels && group_size < MAX_FILTER_CHANNELS; ++next) {
+            S* channel = buffer.getWritePointer(next);
+            instrumentation.check(channel, num_samples);
+            // Copied from the first channel once it is done
+            if (channels.mirrored[next]) {
+                continue;
+            }
+
+            // Once constant input, silence included, has outlasted the tail, the output is constant too
+            if (num_samples > 0) {
+                SteadyInput& steady = channels.steady[next];
+                bool settled = track_steady_input(steady, channel, num_samples, snapshot->tail_samples);
+                if (!curve_static) {
+                    steady.run = 0;
+                }
+                else if (settled) {
+                    for (auto j = 0; j < num_samples; ++j) {
+                        channel[j] = (S)steady.output;
+                    }
+                    skip_decimator(channels.hold[next], num_samples, hold_period);
+                    continue;
+                }
+            }
+            group[group_size] = next;
+            filter_state[group_size] = &channels.filter[next];
+            ++group_size;
+        }
+
+        // Each stage is charged the time since the one before it finished
+        int64_t t = instrumentation.start();
+        for (auto start = 0; start < num_samples && group_size > 0; start += REMAP_BLOCK_SIZE) {
+            int n = juce::jmin(REMAP_BLOCK_SIZE, num_samples - start);
+            for (auto c = 0; c < group_size; ++c) {
+                int i = group[c];
+                x[c] = buffer.getWritePointer(i) + start;
+                for (auto j = 0; j < n; ++j) {
+                    dry[c][j] = x[c][j];
+                }
+                decimate_block(x[c], n, channels.hold[i], hold_period, snapshot->hold_band_limited);
+                gain_block(x[c], n, (S)snapshot->input_gain);
+            }
+            t = instrumentation.lap(STAGE_HOLD, t);
+            if (snapshot->filter_pre == 0) {
+                filter_block(biquad_filter, filter_state, x, group_size, scratch, n, filter_wet, filter_dry);
+                t = instrumentation.lap(STAGE_FILTER, t);
+            }
+
+            // Waveform remapping. A NaN here would vanish in the remapper's NaN check.
+            for (auto c = 0; c < group_size; ++c) {
+                int i = group[c];
+                instrumentation.check(x[c], n);
+                float* remap_io = remap_input(x[c], converted, n);
+                oversampler.upsample(i, remap_io, oversampled_in, n);
+                float morph_from = current_morph + morph_step * start;
+                getWaveformBlock(oversampled_in, oversampled_out, n * oversampler.getFactor(), i, ramp_position + start,
+                    morph_from, morph_from + morph_step * n);
+                oversampler.downsample(i, oversampled_out, remap_io, n);
+                remap_output(remap_io, x[c], n);
+            }
+            t = instrumentation.lap(STAGE_REMAP, t);
+
+            if (snapshot->filter_pre == 1) {
+                filter_block(biquad_filter, filter_state, x, group_size, scratch, n, filter_wet, filter_dry);
+                t = instrumentation.lap(STAGE_FILTER, t);
+            }
+            for (auto c = 0; c < group_size; ++c) {
+                oversampler.delay(group[c], dry[c], n);
+                blend_block(x[c], dry[c], n, dry_gain, wet_gain);
+                output_block(x[c], n, output_gain);
+                instrumentation.check(x[c], n);
+            }
+            t = instrumentation.lap(STAGE_BLEND, t);
+        }
+        for (auto c = 0; c < group_size && num_samples > 0; ++c) {
+            channels.steady[group[c]].output = buffer.getReadPointer(group[c])[num_samples - 1];
+        }
+    }
+
+    for (auto i = 1; i < num_channels; ++i) {
+        if (channels.mirrored[i]) {
+            std::memcpy(buffer.getWritePointer(i), first, sizeof(S) * num_samples);
+        }
+    }
+    ramp_position = juce::jmin(ramp_position + num_samples, ramp_length);
+    current_morph = snapshot->wf_morph;
+}
+
+#if GALOIS_FIXED_POINT
+void Proto_galoisAudioProcessor::processBlockFixed(juce::AudioBuffer<float>& buffer)
+{
+    beginCurveRamp();
+    const TransferTable& table = *transfer_tables[current_table_index];
+    const TransferTable& fading_table = *transfer_tables[previous_table_index];
+
+    // The halvings after the dry blend and the filter blend are folded into the gains
+    const q27 input_gain = to_q27(snapshot->input_gain);
+    const q27 output_gain = to_q27(snapshot->output_level * 0.7f / 2);
+    const q27 filter_blend = to_q27(snapshot->filter_blend / 2);
+    const q27 filter_dry = to_q27((1 - snapshot->filter_blend) / 2);
+    const q27 dry_blend = to_q27(snapshot->dry_blend_sign * snapshot->dry_blend_abs);
+    const q27 wet_blend = to_q27(1 - snapshot->dry_blend_abs);
+    // The integer engine holds for whole samples
+    const int hold_period = (int)(snapshot->hold_period + 0.5);
+
+    for (auto i = 0; i < num_channels; ++i) {
+        float* channel = buffer.getWritePointer(i);
+        FixedBiquad& filter = channels.fixed_filter[i];
+        for (auto j = 0; j < buffer.getNumSamples(); ++j) {
+            q27 dry = to_q27(channel[j]);
+            q27 sample = dry;
+
+            // Sample reduction
+            int& hold_counter = channels.fixed_hold_counter[i];
+            hold_counter++;
+            if (hold_counter >= hold_period) {
+                hold_counter = 0;
+                channels.fixed_hold[i] = sample;
+            }
+            else {
+                sample = channels.fixed_hold[i];
+            }
+
+            // Input level
+            sample = q27_mul(sample, input_gain);
+
+            // Filter
+            if (snapshot->filter_pre == 0) {
+                sample = q27_mul(filter.apply(sample), filter_blend) + q27_mul(sample, filter_dry);
+            }
+
+            // Waveform remapping, crossfaded from the previous curve while a ramp is running
+            q27 wet = table.lookupFixed(sample);
+            if (ramp_position + j < ramp_length) {
+                q27 fading = fading_table.lookupFixed(sample);
+                q27 gain = (q27)(((int64_t)(ramp_position + j + 1) << Q27_BITS) / ramp_length);
+                wet = fading + q27_mul(wet - fading, gain);
+            }
+            sample = wet;
+
+            // Filter
+            if (snapshot->filter_pre == 1) {
+                sample = q27_mul(filter.apply(sample), filter_blend) + q27_mul(sample, filter_dry);
+            }
+
+            // Dry Blend
+            sample = q27_mul(dry, dry_blend) + q27_mul(sample, wet_blend);
+
+            // Output Level, clamped to the valid range before narrowing
+            int64_t out = ((int64_t)sample * output_gain) >> Q27_BITS;
+            out = out > Q27_ONE ? Q27_ONE : (out < -Q27_ONE ? -Q27_ONE : out);
+
+            channel[j] = from_q27((q27)out);
+        }
+    }
+    ramp_position = juce::jmin(ramp_position + buffer.getNumSamples(), ramp_length);
+}
+#endif
+
+const char* Proto_galoisAudioProcessor::getWaveformName() {
+    int i = (int)*tree.getRawParameterValue("wf_base_wave");
+    return wf_names[i];
+
+}
+
+//==============================================================================
+bool Proto_galoisAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* Proto_galoisAudioProcessor::createEditor()
+{
+    return new Proto_galoisAudioProcessorEditor (*this, tree);
+}
+
+//==============================================================================
+void Proto_galoisAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    ParameterValues values;
+    for (int i = 0; i < NUM_STATE_PARAMETERS; ++i) {
+        values.value[i] = *tree.getRawParameterValue(STATE_PARAMETER_IDS[i]);
+        values.is_set[i] = true;
+    }
+    writeBinaryState(values, destData);
+}
+
+void Proto_galoisAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    applyState(data, sizeInBytes);
+}
+
+// A binary state, or the XML that sessions held before it (see PresetBank.cpp)
+bool Proto_galoisAudioProcessor::applyState(const void* data, int sizeInBytes) {
+    ParameterValues values = getDefaultValues();
+    if (readBinaryState(data, sizeInBytes, values)) {
+        applyParameterValues(values);
+        current_programme = -1;
+        return true;
+    }
+    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    return xmlState != nullptr && applyXmlState(*xmlState);
+}
+
+bool Proto_galoisAudioProcessor::applyXmlState(const juce::XmlElement& xml) {
+    ParameterValues values = getDefaultValues();
+    if (!parseXmlState(xml, values)) {
+        return false;
+    }
+    applyParameterValues(values);
+    current_programme = -1;
+    return true;
+}
+
+// Every parameter at its default, for states and presets to be read on top of
+ParameterValues Proto_galoisAudioProcessor::getDefaultValues() const {
+    ParameterValues values;
+    for (int i = 0; i < NUM_STATE_PARAMETERS; ++i) {
+        juce::RangedAudioParameter* parameter = tree.getParameter(STATE_PARAMETER_IDS[i]);
+        values.value[i] = parameter->convertFrom0to1(parameter->getDefaultValue());
+        values.is_set[i] = true;
+    }
+    return values;
+}
+
+/*
+    Sets every parameter that values sets, and rebuilds the snapshot once
+    at the end rather than once per parameter. Hosts are told of each
+    change, as replaceState() would.
+*/
+void Proto_galoisAudioProcessor::applyParameterValues(const ParameterValues& values) {
+    applying_values.store(true, std::memory_order_relaxed);
+    for (int i = 0; i < NUM_STATE_PARAMETERS; ++i) {
+        if (!values.is_set[i]) {
+            continue;
+        }
+        juce::RangedAudioParameter* parameter = tree.getParameter(STATE_PARAMETER_IDS[i]);
+        float normalised = parameter->convertTo0to1(values.value[i]);
+        if (normalised != parameter->getValue()) {
+            parameter->setValueNotifyingHost(normalised);
+        }
+    }
+    applying_values.store(false, std::memory_order_relaxed);
+    parameters_changed.store(true, std::memory_order_release);
+    if (juce::MessageManager::existsAndIsCurrentThread()) {
+        timerCallback();
+    }
+}
+
+void Proto_galoisAudioProcessor::saveFactoryPreset(juce::String name) {
+    juce::ValueTree t = tree.copyState();
+    std::unique_ptr<juce::XmlElement> xml = t.createXml();
+    juce::File dir = juce::File::getSpecialLocation(juce::File::SpecialLocationType::userDocumentsDirectory);
+    juce::String fname = dir.getFullPathName();
+    fname.append("\\preset_", 9);
+    fname.append(name, 99);
+    fname.append(".xml", 4);
+    juce::File f = juce::File(fname);
+    xml->writeTo(f);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new Proto_galoisAudioProcessor();
+}
+
+bool Proto_galoisAudioProcessor::isScalarParameter(const juce::String& parameterID) {
+    for (int i = 0; i < NUM_SCALAR_PARAMETERS; ++i) {
+        if (parameterID == SCALAR_PARAMETER_IDS[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    Fills in the gains, blends and filter coefficients from the scalar
+    parameters, designing the filter for next.filter_type into design. Takes
+    no locks and allocates nothing, so the audio thread uses it as well as
+    cacheWaveforms().
+*/
+void Proto_galoisAudioProcessor::readScalarParameters(ProcessorSnapshot& next, Biquad& design) const {
+    float input_level = *scalar_values[SCALAR_INPUT_LEVEL];
+    input_level = pow(input_level * ROOT_2, 2);
+    float output_level = *scalar_values[SCALAR_OUTPUT_LEVEL];
+    output_level = pow(output_level * ROOT_2, 2);
+    float dry_blend = *scalar_values[SCALAR_DRY_BLEND];
+    next.input_gain = sqrt(input_level);
+    next.output_level = output_level;
+    next.dry_blend_abs = abs(dry_blend);
+    next.dry_blend_sign = sgn(dry_blend);
+    next.filter_blend = *scalar_values[SCALAR_FILTER_BLEND];
+
+    float cutoff = 16 * pow(2, *scalar_values[SCALAR_BIQUAD_CUTOFF]);
+    if (cutoff >= host_sample_rate / 2) {
+        cutoff = host_sample_rate / 2 - 1;
+    }
+    float q = 1.01 - *scalar_values[SCALAR_BIQUAD_Q];
+    design.recalculate(host_sample_rate, cutoff, q, *scalar_values[SCALAR_BIQUAD_GAIN], next.filter_type);
+    design.getCoefficients(next.filter_coefficients);
+    next.filter_initialized = design.isInitialized();
+}
+
+//==============================================================================
+// Listeners can be called on any thread, the audio thread included when the
+// host automates a parameter, so they only flag the change. The snapshot is
+// rebuilt straight away if the change came from the message thread, and by
+// the timer otherwise; changes to the scalar parameters are also read by the
+// audio thread at its next block.
+void Proto_galoisAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue) {
+    // The audio thread applies these at its next block, from whichever thread they come
+    if (isScalarParameter(parameterID)) {
+        scalar_changes.fetch_add(1, std::memory_order_release);
+    }
+    parameters_changed.store(true, std::memory_order_release);
+    // While a whole set of values is applied, the rebuild waits for the last
+    if (juce::MessageManager::existsAndIsCurrentThread() && !applying_values.load(std::memory_order_relaxed)) {
+        timerCallback();
+    }
+}
+
+void Proto_galoisAudioProcessor::timerCallback() {
+    if (parameters_changed.exchange(false, std::memory_order_acq_rel)) {
+        cacheWaveforms();
+    }
+}
+
+void Proto_galoisAudioProcessor::cacheWaveforms() {
+    const juce::ScopedLock lock(snapshot_lock);
+    const int64_t rebuild_started = instrumentation.beginRebuild();
+
+    cached_bit_depth = *tree.getRawParameterValue("bit_depth");
+    cached_sample_rate = *tree.getRawParameterValue("sample_rate");
+    cached_hold_units = *tree.getRawParameterValue("hold_units");
+    cached_hold_rate = *tree.getRawParameterValue("hold_rate");
+    cached_hold_step = *tree.getRawParameterValue("hold_step");
+    cached_wf_base_wave = *tree.getRawParameterValue("wf_base_wave");
+    cached_wf_power = *tree.getRawParameterValue("wf_power");
+    cached_wf_fold = *tree.getRawParameterValue("wf_fold");
+    cached_wf_harm_freq = *tree.getRawParameterValue("wf_harm_freq");
+    cached_wf_harm_amp = *tree.getRawParameterValue("wf_harm_amp");
+    cached_wf_morph_mode = *tree.getRawParameterValue("wf_morph_mode");
+    cached_wf_morph = *tree.getRawParameterValue("wf_morph");
+    cached_dry_blend_mode = *tree.getRawParameterValue("dry_blend_mode");
+    cached_bit_mask = *tree.getRawParameterValue("bit_mask");
+    cached_filter_pre = *tree.getRawParameterValue("filter_pre");
+    int algo = int(*tree.getRawParameterValue("algorithm"));
+    cached_remap_engine = *tree.getRawParameterValue("remap_engine");
+    cached_oversampling = *tree.getRawParameterValue("oversampling");
+    cached_antialiasing = *tree.getRawParameterValue("antialiasing");
+    cached_curve_ramp = *tree.getRawParameterValue("curve_ramp");
+#if GALOIS_FIXED_POINT
+    // The integer engine only has the plain table, at the base rate
+    cached_remap_engine = REMAP_ENGINE_TABLE;
+    cached_oversampling = OVERSAMPLING_1X;
+    cached_antialiasing = ANTIALIASING_OFF;
+    cached_wf_morph_mode = 0;
+#endif
+
+    // While morphing, the display shows the nearest waveform in the bank
+    cached_remap_params.wf = cached_wf_morph_mode ? (int)(cached_wf_morph + 0.5f) : cached_wf_base_wave;
+    cached_remap_params.morph = cached_wf_morph_mode != 0;
+    cached_remap_params.power = cached_wf_power;
+    cached_remap_params.harm_freq = cached_wf_harm_freq;
+    cached_remap_params.harm_amp = cached_wf_harm_amp;
+    cached_remap_params.bit_depth = cached_bit_depth;
+    cached_remap_params.fold_amt = cached_wf_fold;
+    cached_remap_params.mask = cached_bit_mask;
+    cached_remap_params.algorithm = algo;
+    cached_remap_params.math_tier = *tree.getRawParameterValue("math_accuracy");
+    // Morphing bypasses antialiasing, so only then is there no ADAA delay
+    int remap_delay = cached_remap_params.morph ? 0 : adaa_delay(cached_antialiasing);
+    setLatencySamples(Oversampler::getLatencySamples(cached_oversampling, remap_delay));
+
+    // The direct engine evaluates the chain per block, so there is nothing to
+    // compile unless antialiasing needs the table's antiderivatives or
+    // morphing needs the bank
+    if (cached_remap_engine == REMAP_ENGINE_TABLE || cached_antialiasing != ANTIALIASING_OFF || cached_remap_params.morph) {
+        compileTransferTable();
+    }
+
+    // Hand everything processBlock needs to the audio thread in one go
+    int slot = snapshots.getFreeSlot();
+    ProcessorSnapshot& next = snapshots[slot];
+    // A rate in Hz follows the host's sample rate, and gives a fractional period
+    double hold_period = cached_hold_units == HOLD_UNITS_HZ ? host_sample_rate / cached_hold_rate : cached_sample_rate;
+    next.hold_period = juce::jmax(1.0, hold_period);
+    next.hold_band_limited = cached_hold_step == HOLD_STEP_BAND_LIMITED;
+    next.filter_pre = cached_filter_pre;
+    // The count is read first, so that a change racing with this rebuild is read again by the audio thread
+    next.scalar_version = scalar_changes.load(std::memory_order_acquire);
+    next.filter_type = cached_biquad_type;
+    Biquad design;
+    readScalarParameters(next, design);
+    // How long the chain rings on once its input stops changing. The hold
+    // sustains a sample for its period, plus one for the band-limited step's
+    // delay, and antialiasing looks two samples back.
+    next.tail_samples = design.getTailSamples(FILTER_TAIL_LEVEL, (int)(MAX_TAIL_SECONDS * host_sample_rate))
+        + Oversampler::getSettlingSamples(cached_oversampling, remap_delay) + (int)ceil(next.hold_period) + 1 + 2;
+    tail_samples.store(next.tail_samples, std::memory_order_relaxed);
+    next.remap_engine = cached_remap_engine;
+    next.oversampling = cached_oversampling;
+    next.antialiasing = cached_antialiasing;
+    next.remap_delay = remap_delay;
+    next.curve_ramp = cached_curve_ramp;
+    next.wf_morph = cached_wf_morph;
+    next.remap_params = cached_remap_params;
+    snapshots.publish(slot);
+
+    // The editor redraws only when the curve itself has changed. RemapParams
+    // ignores wf while morphing, but the display shows it.
+    const DisplaySnapshot& shown = display_snapshots[display_snapshots.getPublished()];
+    if (!(shown.remap_params == cached_remap_params) || shown.remap_params.wf != cached_remap_params.wf) {
+        int display_slot = display_snapshots.getFreeSlot();
+        display_snapshots[display_slot].remap_params = cached_remap_params;
+        display_snapshots[display_slot].version = display_version.load(std::memory_order_relaxed) + 1;
+        display_snapshots.publish(display_slot);
+        display_version.store(display_snapshots[display_slot].version, std::memory_order_release);
+    }
+    instrumentation.endRebuild(rebuild_started);
+}
+
+int Proto_galoisAudioProcessor::getDisplayVersion() const {
+    return display_version.load(std::memory_order_acquire);
+}
+
+/*
+    Fills out with n points of the transfer curve over [-1, 1], from the
+    latest published parameters, and returns their version. n must be at
+    least 2. Only the editor calls this, since it is the one reader of
+    display_snapshots.
+*/
+int Proto_galoisAudioProcessor::renderDisplayCurve(float* out, int n) {
+    const DisplaySnapshot& shown = display_snapshots[display_snapshots.acquire(-1)];
+    float half = (float)(n - 1) / 2;
+    for (int i = 0; i < n; i++) {
+        float amp = (float)(i - half) / half;
+        out[i] = remap_sample(amp, shown.remap_params);
+    }
+    return shown.version;
+}
+
+void Proto_galoisAudioProcessor::compileTransferTable() {
+    const std::shared_ptr<const TransferTable>& published = transfer_tables[transfer_tables.getPublished()];
+    if (published != nullptr && published->isCompiledFor(cached_remap_params)) {
+        return;
+    }
+    // Replacing the slot's old table may free it, here rather than on the audio thread
+    int next = transfer_tables.getFreeSlot();
+    transfer_tables[next] = TransferTableCache::getInstance().get(cached_remap_params);
+    instrumentation.setCurveNanPoints(transfer_tables[next]->getNanPoints());
+    transfer_tables.publish(next);
+}
+
+void Proto_galoisAudioProcessor::setInstrumentationEnabled(bool enabled) {
+    instrumentation.setEnabled(enabled);
+}
+
+void Proto_galoisAudioProcessor::resetInstrumentation() {
+    instrumentation.reset();
+}
+
+InstrumentationReport Proto_galoisAudioProcessor::getInstrumentationReport() const {
+    return instrumentation.getReport();
+}
+
+juce::String Proto_galoisAudioProcessor::getFilterPosition() {
+    int i = *tree.getRawParameterValue("filter_pre");
+    return biquad_position_names[i];
+}
+
+juce::String Proto_galoisAudioProcessor::getFilterType() {
+    return biquad_type_names[cached_biquad_type];
+}
+
+void Proto_galoisAudioProcessor::cycleParamValue(juce::String parameterID) {
+    if (parameterID == "biquad_type") {
+        int current = cached_biquad_type;
+        ++current;
+        if (current > 2) {
+            current = 0;
+        }
+        cached_biquad_type = current;
+        cacheWaveforms();
+    }
+    else {
+        int current = *tree.getRawParameterValue(parameterID);
+        ++current;
+        if (current > (tree.getParameter(parameterID)->getNormalisableRange().end)) {
+            current = 0;
+        }
+        tree.getParameter(parameterID)->beginChangeGesture();
+        tree.getParameter(parameterID)->setValueNotifyingHost(current);
+        tree.getParameter(parameterID)->endChangeGesture();
+        parameterChanged(parameterID, current);
+    }
+}
+
+
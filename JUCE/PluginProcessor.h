@@ -1,129 +1,317 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "Biquad.cpp"
-
-//==============================================================================
-/**
-*/
-class Proto_galoisAudioProcessor  : public juce::AudioProcessor
-                            , public juce::AudioProcessorValueTreeState::Listener
-                            #if JucePlugin_Enable_ARA
-                             , public juce::AudioProcessorARAExtension
-                            #endif
-{
-public:
-    //==============================================================================
-    Proto_galoisAudioProcessor();
-    ~Proto_galoisAudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    float getWaveformValue(float sample);
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-
-    //==============================================================================
-    // Parameters
-    juce::AudioProcessorValueTreeState tree;
-    void parameterChanged(const juce::String& parameterID, float newValue);
-    void cacheWaveforms();
-    const char* getWaveformName();
-
-    float* waveform_cache;
-    const int waveform_resolution = 200;
-
-    void saveFactoryPreset(juce::String name);
-    juce::String getFilterPosition();
-    juce::String getFilterType();
-    void cycleParamValue(juce::String parameterID);
-
-private:
-
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Proto_galoisAudioProcessor)
-    double host_sample_rate;
-    int num_channels;
-
-    float* sample_reduction_register;
-    int sample_reduction_counter;
-
-    // Filter 
-    Biquad* biquad_filter;
-    float cached_biquad_cutoff;
-    float cached_biquad_q;
-    float cached_biquad_gain;
-    int cached_biquad_type;
-    int cached_filter_pre;
-    float cached_filter_blend;
-    void updateFilter();
-    float apply_filter(float sample, int channel);
-
-    juce::String* biquad_position_names;
-    juce::String* biquad_type_names;
-
-    // Cached parameter values
-    float cached_bit_depth;
-    int cached_sample_rate;
-    float cached_output_level;
-    float cached_input_level;
-    int cached_wf_base_wave;
-    float cached_wf_power;
-    float cached_wf_fold;
-    float cached_wf_harm_freq;
-    float cached_wf_harm_amp;
-    float cached_dry_blend;
-    float cached_dry_blend_abs;
-    float cached_dry_blend_sign;
-    int cached_dry_blend_mode;
-    int cached_bit_mask;
-    float cached_low_cutoff;
-    int* cached_algorithm;
-
-    // Algorithms
-    void generate_algorithms();
-    int** algorithms;
-
-    // Factory Presets
-    juce::String* preset_names;
-    juce::String* preset_filenames;
-    int current_programme;
-    const int NUM_PROGRAMMES = 21;
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Biquad.cpp"
+#include "DspArena.cpp"
+#include "Oversampler.cpp"
+#include "FixedPoint.cpp"
+#include "RemapParams.h"
+#include "SlotExchange.cpp"
+#include "Instrumentation.cpp"
+#include "PresetBank.cpp"
+
+class TransferTable;
+struct StageConstants;
+struct AdaaState;
+struct SteadyInput;
+struct DecimatorState;
+
+// How the remapping chain is evaluated in processBlock
+enum {
+    REMAP_ENGINE_TABLE,     // Interpolated lookup in a compiled transfer table
+    REMAP_ENGINE_DIRECT     // SIMD block kernels, for audio-rate parameter changes
+};
+
+// processBlock hands the remapper this many samples at a time
+const int REMAP_BLOCK_SIZE = 64;
+
+// Enough transfer tables that one is always free to compile into: the audio
+// thread may be fading between two while a third waits to be picked up
+const int NUM_TRANSFER_TABLES = 4;
+
+// The filter's tail ends once it has decayed by 100 dB, or after 10 seconds if it never does
+const double FILTER_TAIL_LEVEL = 1e-5;
+const double MAX_TAIL_SECONDS = 10;
+
+/*
+    Everything processBlock reads from the parameters. A snapshot is built
+    off the audio thread and handed over whole, so the audio thread never
+    sees a half-updated set. The audio thread works on a copy, in which it
+    can bring the gains, blends and filter up to date itself.
+*/
+struct ProcessorSnapshot {
+    double hold_period = 1;         // Sample-and-hold period, in samples and at least one
+    bool hold_band_limited = false;
+    float input_gain = 1;
+    float output_level = 1;
+    float dry_blend_abs = 0;
+    float dry_blend_sign = 0;
+    int filter_pre = 1;
+    float filter_blend = 0;
+    float filter_coefficients[5] = { 0, 0, 0, 0, 0 };
+    bool filter_initialized = false;
+    int filter_type = 0;
+    int remap_engine = REMAP_ENGINE_TABLE;
+    int oversampling = OVERSAMPLING_1X;
+    int antialiasing = 0;
+    int remap_delay = 0;            // Oversampled-rate samples the remapper delays by
+    float curve_ramp = 0;
+    float wf_morph = 0;
+    RemapParams remap_params;
+    int tail_samples = 0;           // Until a constant input gives a constant output
+    int scalar_version = 0;         // scalar_changes when the scalar parameters were read
+};
+
+// The parameters that only set gains, blends or filter coefficients, which
+// the audio thread reads for itself rather than waiting for a rebuild
+const char* const SCALAR_PARAMETER_IDS[] = {
+    "input_level", "output_level", "dry_blend", "filter_blend", "biquad_cutoff", "biquad_q", "biquad_gain"
+};
+const int NUM_SCALAR_PARAMETERS = sizeof(SCALAR_PARAMETER_IDS) / sizeof(SCALAR_PARAMETER_IDS[0]);
+enum {
+    SCALAR_INPUT_LEVEL,
+    SCALAR_OUTPUT_LEVEL,
+    SCALAR_DRY_BLEND,
+    SCALAR_FILTER_BLEND,
+    SCALAR_BIQUAD_CUTOFF,
+    SCALAR_BIQUAD_Q,
+    SCALAR_BIQUAD_GAIN
+};
+
+/*
+    The state each channel carries from one block to the next. There is one
+    array per stage, each holding every channel's state for that stage next
+    to each other, and all of them are in the processor's arena. A stage
+    running over a channel touches only its own array, and adding channels
+    only lengthens the arrays.
+*/
+struct ChannelState {
+    DecimatorState* hold = 0;       // Sample-and-hold phase and register
+    Biquad::State* filter = 0;      // Filter state, for the shared coefficients
+    AdaaState* adaa = 0;            // Antialiasing history
+    SteadyInput* steady = 0;        // For skipping the chain on constant input
+    int* identical_run = 0;         // Samples the input has matched the first channel's
+    bool* mirrored = 0;             // The first channel's state stands in for this one's
+#if GALOIS_FIXED_POINT
+    q27* fixed_hold = 0;
+    int* fixed_hold_counter = 0;
+    FixedBiquad* fixed_filter = 0;
+#endif
+};
+
+// The audio thread holds one snapshot, one is published and one is free to build
+const int NUM_SNAPSHOTS = 3;
+
+// The remapping parameters the editor draws the curve from. version goes up
+// each time they change, so the editor knows when its curve is stale.
+struct DisplaySnapshot {
+    RemapParams remap_params;
+    int version = 0;
+};
+
+//==============================================================================
+/**
+*/
+class Proto_galoisAudioProcessor  : public juce::AudioProcessor
+                            , public juce::AudioProcessorValueTreeState::Listener
+                            , private juce::Timer
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    Proto_galoisAudioProcessor();
+    ~Proto_galoisAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
+
+    void getWaveformBlock(const float* in, float* out, int n, int channel, int ramp_start, float morph_from, float morph_to);
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    // Applies a saved state or an XML preset, and returns false if it is
+    // neither. For the offline tools, which need to know.
+    bool applyState(const void* data, int sizeInBytes);
+    bool applyXmlState(const juce::XmlElement& xml);
+
+    //==============================================================================
+    // Parameters
+    juce::AudioProcessorValueTreeState tree;
+    void parameterChanged(const juce::String& parameterID, float newValue);
+    void cacheWaveforms();
+    const char* getWaveformName();
+
+    // Display curve, for the editor on the message thread. The curve is
+    // only computed when the editor asks for it.
+    int getDisplayVersion() const;
+    int renderDisplayCurve(float* out, int n);
+
+    // Transfer tables
+    void compileTransferTable();
+
+    // Per-stage timings and signal health, off until enabled (see
+    // Instrumentation.cpp). Any thread may call these.
+    void setInstrumentationEnabled(bool enabled);
+    void resetInstrumentation();
+    InstrumentationReport getInstrumentationReport() const;
+
+    void saveFactoryPreset(juce::String name);
+    juce::String getFilterPosition();
+    juce::String getFilterType();
+    void cycleParamValue(juce::String parameterID);
+
+private:
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Proto_galoisAudioProcessor)
+    double host_sample_rate;
+    int num_channels;
+
+    // Per-channel DSP state, all of it in the arena
+    DspArena arena;
+    void allocateChannelState();
+    void copyChannelState(int from, int to);
+    ChannelState channels;
+
+    // The snapshot's tail_samples, for hosts asking from any thread
+    std::atomic<int> tail_samples;
+
+    Instrumentation instrumentation;
+
+    // Filter coefficients, shared by every channel
+    Biquad biquad_filter;
+    int cached_biquad_type;
+    int cached_filter_pre;
+
+    template <typename S> void processChain(juce::AudioBuffer<S>& buffer);
+
+#if GALOIS_FIXED_POINT
+    // Integer engine, see FixedPoint.cpp
+    void processBlockFixed(juce::AudioBuffer<float>& buffer);
+#endif
+
+    juce::String* biquad_position_names;
+    juce::String* biquad_type_names;
+
+    // Cached parameter values
+    float cached_bit_depth;
+    int cached_sample_rate;
+    int cached_hold_units;
+    float cached_hold_rate;
+    int cached_hold_step;
+    int cached_wf_base_wave;
+    float cached_wf_power;
+    float cached_wf_fold;
+    float cached_wf_harm_freq;
+    float cached_wf_harm_amp;
+    int cached_wf_morph_mode;
+    float cached_wf_morph;
+    int cached_dry_blend_mode;
+    int cached_bit_mask;
+    float cached_low_cutoff;
+    int cached_remap_engine;
+    RemapParams cached_remap_params;
+    int cached_oversampling;
+    int cached_antialiasing;
+
+    // Oversampling around the remapper
+    Oversampler oversampler;
+
+    // Parameter snapshots. Listeners only flag a change; the snapshot is
+    // rebuilt on the message thread, or in processBlock when rendering
+    // offline, under snapshot_lock so that there is only one writer. Changes
+    // to the scalar parameters are also counted in scalar_changes below.
+    SlotExchange<ProcessorSnapshot, NUM_SNAPSHOTS> snapshots;
+    std::atomic<bool> parameters_changed;
+    // Set while a whole state is applied, so that the listeners leave the rebuild until the end
+    std::atomic<bool> applying_values;
+    ParameterValues getDefaultValues() const;
+    void applyParameterValues(const ParameterValues& values);
+    juce::CriticalSection snapshot_lock;
+    void timerCallback() override;
+
+    // The remapping parameters for the display. The editor is the reader.
+    SlotExchange<DisplaySnapshot, NUM_SNAPSHOTS> display_snapshots;
+    std::atomic<int> display_version;
+
+    // The audio thread's snapshot for the current block: its own copy of the
+    // published one, with the scalar parameters brought up to date
+    const ProcessorSnapshot* snapshot;
+    ProcessorSnapshot live_snapshot;
+    int snapshot_slot;
+    void acquireSnapshot();
+
+    // Counts changes to the scalar parameters. A snapshot older than the
+    // count has its scalars read again by the audio thread, from the values
+    // in SCALAR_PARAMETER_IDS order, so that automating them takes effect on
+    // the next block rather than at the next rebuild.
+    std::atomic<int> scalar_changes;
+    std::atomic<float>* scalar_values[NUM_SCALAR_PARAMETERS];
+    static bool isScalarParameter(const juce::String& parameterID);
+    void readScalarParameters(ProcessorSnapshot& next, Biquad& design) const;
+
+    // Compiled remapping chain, from the shared cache (see TransferTableCache.cpp).
+    // The writer fills slots the audio thread is not reading, so the audio
+    // thread never lets go of a table.
+    SlotExchange<std::shared_ptr<const TransferTable>, NUM_TRANSFER_TABLES> transfer_tables;
+
+    // Crossfading between curves when the remapping parameters change. The
+    // audio thread moves on to the active table (or, for the direct engine,
+    // the current parameters) only once any running crossfade has finished.
+    float cached_curve_ramp;
+    int current_table_index;
+    int previous_table_index;
+    RemapParams current_params;
+    RemapParams previous_params;
+    int ramp_length;
+    int ramp_position;
+    void beginCurveRamp();
+    void remapBlock(const TransferTable& table, const RemapParams& params, AdaaState& state, const float* in, float* out, int n, float morph_from, float morph_to);
+
+    // Morph position reached at the end of the last block, swept towards the snapshot's
+    float current_morph;
+
+    // Factory Presets
+    int current_programme;
+    const int NUM_PROGRAMMES = NUM_FACTORY_PRESETS;
+};
@@ -0,0 +1,100 @@
+/*
+    The XML states and the factory presets, on top of the plain parameter
+    values and binary state in StateFormat.cpp. The factory presets are
+    parsed once per process from the binary data rather than on every
+    programme change.
+
+    States and presets are read on top of every parameter's default, so
+    that a parameter they have no value for is reset to its default, as
+    replaceState() reset it. Most factory presets predate some of the
+    parameters, and without the reset would keep those from the previous
+    programme. Sessions saved before the binary format hold XML, which
+    still loads.
+*/
+#pragma once
+#include <JuceHeader.h>
+#include "StateFormat.cpp"
+
+// Reads the <PARAM id value> children of an XML state or preset, leaving
+// the values it has no child for as they were
+inline bool parseXmlState(const juce::XmlElement& xml, ParameterValues& values) {
+    if (!xml.hasTagName(STATE_TYPE)) {
+        return false;
+    }
+    for (auto* param : xml.getChildWithTagNameIterator("PARAM")) {
+        int i = findStateParameter(param->getStringAttribute("id").toRawUTF8());
+        if (i >= 0 && param->hasAttribute("value")) {
+            values.value[i] = (float)param->getDoubleAttribute("value");
+            values.is_set[i] = true;
+        }
+    }
+    return true;
+}
+
+inline void writeBinaryState(const ParameterValues& values, juce::MemoryBlock& data) {
+    std::vector<uint8_t> bytes;
+    writeBinaryState(values, bytes);
+    data.setSize(0);
+    data.append(bytes.data(), bytes.size());
+}
+
+//==============================================================================
+struct FactoryPreset {
+    const char* name;
+    const char* resource;   // In BinaryData
+};
+
+const FactoryPreset FACTORY_PRESETS[] = {
+    { "Init",                       "preset_Init_xml" },
+    { "Bad Radio",                  "preset_BadRadio_xml" },
+    { "Cavernous Ringing",          "preset_CarvernousRinging_xml" },
+    { "Clean Octave Up",            "preset_CleanOctaveUp_xml" },
+    { "Clean Transformer Splatter", "preset_CleanTransformerSplatter_xml" },
+    { "Dirty Wavefolder",           "preset_DirtyFolder_xml" },
+    { "Dynamic Fuzz",               "preset_DynamicFuzz_xml" },
+    { "Eight Bit Chomp",            "preset_EightBitChomp_xml" },
+    { "Fizzy Crunch",               "preset_FizzyCrunch_xml" },
+    { "Gated Square",               "preset_GatedSquare_xml" },
+    { "Green Ringer",               "preset_GreenRinger_xml" },
+    { "Harmonic Croaker",           "preset_HarmonicCroaker_xml" },
+    { "Lazer Octave",               "preset_LazerOctave_xml" },
+    { "Light Splatter",             "preset_LightSplatter_xml" },
+    { "Medium Overdrive",           "preset_MediumOverdrive_xml" },
+    { "Midrange Honk",              "preset_MidrangeHonk_xml" },
+    { "Modem",                      "preset_Modem_xml" },
+    { "Octave Fuzz",                "preset_OctaveFuzz_xml" },
+    { "Passive Transformer",        "preset_PassiveTransformer_xml" },
+    { "Purring Logic Gates",        "preset_PurringLogicGates_xml" },
+    { "Throaty Crunch",             "preset_ThroatyCrunch_xml" }
+};
+const int NUM_FACTORY_PRESETS = sizeof(FACTORY_PRESETS) / sizeof(FACTORY_PRESETS[0]);
+
+// The factory presets, parsed the first time any instance asks for them.
+// Every instance has the same defaults, so the first one's are used.
+class FactoryPresetBank
+{
+public:
+    static const FactoryPresetBank& getInstance(const ParameterValues& defaults) {
+        static FactoryPresetBank bank(defaults);
+        return bank;
+    }
+
+    const ParameterValues& getValues(int index) const {
+        return presets[index];
+    }
+
+private:
+    explicit FactoryPresetBank(const ParameterValues& defaults) {
+        for (int i = 0; i < NUM_FACTORY_PRESETS; ++i) {
+            presets[i] = defaults;
+            int size = 0;
+            const char* xml = BinaryData::getNamedResource(FACTORY_PRESETS[i].resource, size);
+            std::unique_ptr<juce::XmlElement> element = juce::XmlDocument::parse(juce::String::fromUTF8(xml, size));
+            if (element != nullptr) {
+                parseXmlState(*element, presets[i]);
+            }
+        }
+    }
+
+    ParameterValues presets[NUM_FACTORY_PRESETS];
+};
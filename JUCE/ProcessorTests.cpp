@@ -0,0 +1,322 @@
+/*
+	Checks on the whole processor, which need JUCE:
+
+		GaloisProcessorTests [test ...]
+
+	Runs like GaloisDspTests: with no arguments every test runs, otherwise
+	only the ones named, and the exit code is the number that failed.
+	CMakeLists.txt registers each test with CTest under its own name. This
+	is the GaloisProcessorTests target, built like BatchRender.cpp.
+*/
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Decimator.cpp"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+const double TEST_SAMPLE_RATE = 48000;
+const int TEST_CHANNELS = 2;
+const int TEST_BLOCK_SIZE = 512;
+
+static bool check(bool condition, const char* what) {
+    printf("  %s%s\n", what, condition ? "" : " FAILED");
+    return condition;
+}
+
+static void prepare(Proto_galoisAudioProcessor& processor, int block_size) {
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(TEST_CHANNELS, TEST_CHANNELS, TEST_SAMPLE_RATE, block_size);
+    processor.prepareToPlay(TEST_SAMPLE_RATE, block_size);
+}
+
+// A quarter of a second of a sine in the left channel and noise in the right
+static juce::AudioBuffer<float> makeTestSignal() {
+    const int length = (int)(TEST_SAMPLE_RATE / 4);
+    juce::AudioBuffer<float> buffer(TEST_CHANNELS, length);
+    uint32_t seed = 1;
+    for (int i = 0; i < length; ++i) {
+        seed = seed * 1664525 + 1013904223;
+        buffer.setSample(0, i, (float)(0.7 * sin(2 * M_PI * 220 * i / TEST_SAMPLE_RATE)));
+        buffer.setSample(1, i, 0.5f * ((float)(seed >> 8) / (1 << 23) - 1));
+    }
+    return buffer;
+}
+
+static void setParameter(Proto_galoisAudioProcessor& processor, const char* id, float value) {
+    juce::RangedAudioParameter* parameter = processor.tree.getParameter(id);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+// Processes buffer in place, in blocks of the sizes given, over and over
+static void render(Proto_galoisAudioProcessor& processor, juce::AudioBuffer<float>& buffer, const std::vector<int>& block_sizes) {
+    juce::AudioBuffer<float> block(TEST_CHANNELS, *std::max_element(block_sizes.begin(), block_sizes.end()));
+    juce::MidiBuffer midi;
+    size_t next_size = 0;
+    for (int position = 0, n = 0; position < buffer.getNumSamples(); position += n) {
+        n = juce::jmin(block_sizes[next_size], buffer.getNumSamples() - position);
+        next_size = (next_size + 1) % block_sizes.size();
+        block.setSize(TEST_CHANNELS, n, false, false, true);
+        for (int c = 0; c < TEST_CHANNELS; ++c) {
+            block.copyFrom(c, 0, buffer, c, position, n);
+        }
+        processor.processBlock(block, midi);
+        for (int c = 0; c < TEST_CHANNELS; ++c) {
+            buffer.copyFrom(c, position, block, c, 0, n);
+        }
+    }
+}
+
+static void render(Proto_galoisAudioProcessor& processor, juce::AudioBuffer<float>& buffer, int block_size) {
+    render(processor, buffer, std::vector<int>{ block_size });
+}
+
+static bool sameSamples(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b, int channel) {
+    return a.getNumSamples() == b.getNumSamples()
+        && memcmp(a.getReadPointer(channel), b.getReadPointer(channel), sizeof(float) * a.getNumSamples()) == 0;
+}
+
+//==============================================================================
+// preset_switch: a factory preset sets every parameter, so switching to it
+// from any other gives what loading it into a fresh processor does
+
+static bool testPresetSwitch() {
+    juce::MemoryBlock fresh_states[NUM_FACTORY_PRESETS];
+    for (int b = 0; b < NUM_FACTORY_PRESETS; ++b) {
+        Proto_galoisAudioProcessor fresh;
+        fresh.setCurrentProgram(b);
+        fresh.getStateInformation(fresh_states[b]);
+    }
+
+    int mismatches = 0;
+    for (int a = 0; a < NUM_FACTORY_PRESETS; ++a) {
+        Proto_galoisAudioProcessor processor;
+        for (int b = 0; b < NUM_FACTORY_PRESETS; ++b) {
+            processor.setCurrentProgram(a);
+            processor.setCurrentProgram(b);
+            juce::MemoryBlock state;
+            processor.getStateInformation(state);
+            if (state != fresh_states[b]) {
+                printf("  %s after %s differs from a fresh load\n", FACTORY_PRESETS[b].name, FACTORY_PRESETS[a].name);
+                ++mismatches;
+            }
+        }
+    }
+    bool passed = check(mismatches == 0, "every preset's parameters after every other preset");
+
+    // The sound as well. The switch is made before prepareToPlay(), which
+    // ends the crossfade from the old curve that a switch while playing starts.
+    const juce::AudioBuffer<float> input = makeTestSignal();
+    int audio_mismatches = 0;
+    for (int b = 0; b < NUM_FACTORY_PRESETS; ++b) {
+        int a = (b + 1) % NUM_FACTORY_PRESETS;
+        Proto_galoisAudioProcessor switched;
+        switched.setCurrentProgram(a);
+        switched.setCurrentProgram(b);
+        prepare(switched, TEST_BLOCK_SIZE);
+        Proto_galoisAudioProcessor fresh;
+        fresh.setCurrentProgram(b);
+        prepare(fresh, TEST_BLOCK_SIZE);
+
+        juce::AudioBuffer<float> switched_output;
+        switched_output.makeCopyOf(input);
+        render(switched, switched_output, TEST_BLOCK_SIZE);
+        juce::AudioBuffer<float> fresh_output;
+        fresh_output.makeCopyOf(input);
+        render(fresh, fresh_output, TEST_BLOCK_SIZE);
+        for (int c = 0; c < TEST_CHANNELS; ++c) {
+            audio_mismatches += !sameSamples(switched_output, fresh_output, c);
+        }
+    }
+    passed &= check(audio_mismatches == 0, "every preset renders the same after the next one");
+    return passed;
+}
+
+//==============================================================================
+// mirrored_channels: a channel whose input repeats the first channel's is
+// copied from it rather than processed, and takes over the first channel's
+// state when the inputs part (PluginProcessor.cpp). Both must give exactly
+// what processing the channel all along does, which the first channel of a
+// render whose channels never match shows.
+
+static bool testMirroredChannels() {
+    const juce::AudioBuffer<float> signal = makeTestSignal();
+    const int length = signal.getNumSamples();
+    const int parting = length / 2 + 100;   // Within a block
+
+    // The left channel's signal in both, until the right one switches to its own
+    juce::AudioBuffer<float> mirrored;
+    mirrored.makeCopyOf(signal);
+    mirrored.copyFrom(1, 0, signal, 0, 0, parting);
+    // The right channel of that in the left, where it is never mirrored
+    juce::AudioBuffer<float> right_alone;
+    right_alone.makeCopyOf(signal);
+    right_alone.copyFrom(0, 0, mirrored, 1, 0, length);
+
+    int mismatches = 0;
+    for (int program = 0; program < NUM_FACTORY_PRESETS; ++program) {
+        juce::AudioBuffer<float> outputs[3];
+        const juce::AudioBuffer<float>* inputs[3] = { &mirrored, &signal, &right_alone };
+        for (int r = 0; r < 3; ++r) {
+            Proto_galoisAudioProcessor processor;
+            processor.setCurrentProgram(program);
+            prepare(processor, TEST_BLOCK_SIZE);
+            outputs[r].makeCopyOf(*inputs[r]);
+            render(processor, outputs[r], TEST_BLOCK_SIZE);
+        }
+        bool left = sameSamples(outputs[0], outputs[1], 0);
+        // The right channel of the first render against the left of the last
+        juce::AudioBuffer<float> right(1, length);
+        right.copyFrom(0, 0, outputs[0], 1, 0, length);
+        bool right_matches = sameSamples(right, outputs[2], 0);
+        if (!left || !right_matches) {
+            printf("  %s: the %s channel differs from processing it alone\n", FACTORY_PRESETS[program].name, left ? "right" : "left");
+            ++mismatches;
+        }
+    }
+    return check(mismatches == 0, "copied channels match processed ones, before and after the inputs part");
+}
+
+//==============================================================================
+// hold_block_split: the sample-and-hold keeps its phase and its fractional
+// period across blocks (Decimator.cpp), so with the hold at a rate in Hz
+// every preset renders the same whatever sizes the host's blocks are
+
+static bool testHoldBlockSplit() {
+    struct HoldSetting {
+        float rate;     // Hz
+        int step;
+    };
+    const HoldSetting settings[] = {
+        { 7351.3f, HOLD_STEP_PLAIN },
+        { 7351.3f, HOLD_STEP_BAND_LIMITED },
+        { 333.3f, HOLD_STEP_BAND_LIMITED },
+    };
+    const std::vector<int> irregular = { 1, 7, 64, 333, 1000, 2 };
+    const juce::AudioBuffer<float> input = makeTestSignal();
+
+    int mismatches = 0;
+    for (int program = 0; program < NUM_FACTORY_PRESETS; ++program) {
+        for (const HoldSetting& setting : settings) {
+            juce::AudioBuffer<float> outputs[2];
+            for (int r = 0; r < 2; ++r) {
+                Proto_galoisAudioProcessor processor;
+                processor.setCurrentProgram(program);
+                setParameter(processor, "hold_units", HOLD_UNITS_HZ);
+                setParameter(processor, "hold_rate", setting.rate);
+                setParameter(processor, "hold_step", setting.step);
+                prepare(processor, r == 0 ? TEST_BLOCK_SIZE : 1000);
+                outputs[r].makeCopyOf(input);
+                if (r == 0) {
+                    render(processor, outputs[r], TEST_BLOCK_SIZE);
+                }
+                else {
+                    render(processor, outputs[r], irregular);
+                }
+            }
+            for (int c = 0; c < TEST_CHANNELS; ++c) {
+                if (!sameSamples(outputs[0], outputs[1], c)) {
+                    printf("  %s at %g Hz%s: channel %d depends on the block sizes\n", FACTORY_PRESETS[program].name,
+                        setting.rate, setting.step == HOLD_STEP_BAND_LIMITED ? ", band-limited" : "", c);
+                    ++mismatches;
+                }
+            }
+        }
+    }
+    return check(mismatches == 0, "blocks of 512 samples and of irregular sizes render the same");
+}
+
+//==============================================================================
+// curve_ramp: a change of curve while playing fades in over curve_ramp
+// milliseconds, rather than stepping at a block boundary. Through the
+// switch, a sine moves in a sample no more than twice as far as it does on
+// either curve, while with no ramp the step shows.
+
+// The largest change from one sample to the next in channel 0, over [start, end)
+static float largestStep(const juce::AudioBuffer<float>& buffer, int start, int end) {
+    float largest = 0;
+    for (int i = juce::jmax(1, start); i < end; ++i) {
+        largest = juce::jmax(largest, std::abs(buffer.getSample(0, i) - buffer.getSample(0, i - 1)));
+    }
+    return largest;
+}
+
+static bool testCurveRamp() {
+    const int length = (int)(TEST_SAMPLE_RATE / 2);
+    const int half = length / 2 + 109;     // At a trough, where the two curves are far apart
+    juce::AudioBuffer<float> input(TEST_CHANNELS, length);
+    for (int i = 0; i < length; ++i) {
+        for (int c = 0; c < TEST_CHANNELS; ++c) {
+            input.setSample(c, i, (float)(0.35 * sin(2 * M_PI * 110 * i / TEST_SAMPLE_RATE)));
+        }
+    }
+
+    float switch_steps[2];
+    float steady_step = 0;
+    const float ramps[2] = { 0, 20 };
+    for (int r = 0; r < 2; ++r) {
+        Proto_galoisAudioProcessor processor;
+        setParameter(processor, "curve_ramp", ramps[r]);
+        prepare(processor, TEST_BLOCK_SIZE);
+        // Each half on its own, so that the switch falls between them
+        juce::AudioBuffer<float> before(TEST_CHANNELS, half);
+        juce::AudioBuffer<float> after(TEST_CHANNELS, length - half);
+        for (int c = 0; c < TEST_CHANNELS; ++c) {
+            before.copyFrom(c, 0, input, c, 0, half);
+            after.copyFrom(c, 0, input, c, half, length - half);
+        }
+        render(processor, before, TEST_BLOCK_SIZE);
+        setParameter(processor, "wf_base_wave", 5);
+        render(processor, after, TEST_BLOCK_SIZE);
+        juce::AudioBuffer<float> output(TEST_CHANNELS, length);
+        for (int c = 0; c < TEST_CHANNELS; ++c) {
+            output.copyFrom(c, 0, before, c, 0, half);
+            output.copyFrom(c, half, after, c, 0, length - half);
+        }
+
+        // A full period of 110 Hz either side, away from the switch
+        const int period = (int)(TEST_SAMPLE_RATE / 110) + 1;
+        steady_step = juce::jmax(steady_step, largestStep(output, half - 2 * period, half - period),
+                                 largestStep(output, length - period, length));
+        switch_steps[r] = largestStep(output, half - 1, half + period);
+        printf("  %g ms: %.5f at the switch\n", ramps[r], switch_steps[r]);
+    }
+    printf("  %.5f on either curve\n", steady_step);
+    bool passed = check(switch_steps[1] <= 2 * steady_step, "with a 20 ms ramp the switch is no steeper than the sine");
+    passed &= check(switch_steps[0] > 2 * steady_step, "with no ramp it steps");
+    return passed;
+}
+
+//==============================================================================
+
+struct ProcessorTest {
+    const char* name;
+    bool (*run)();
+};
+
+const ProcessorTest PROCESSOR_TESTS[] = {
+    { "preset_switch", testPresetSwitch },
+    { "mirrored_channels", testMirroredChannels },
+    { "hold_block_split", testHoldBlockSplit },
+    { "curve_ramp", testCurveRamp },
+};
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juce_initialiser;
+    int failures = 0;
+    for (const ProcessorTest& test : PROCESSOR_TESTS) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || strcmp(argv[i], test.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        printf("%s\n", test.name);
+        bool passed = test.run();
+        printf("%s: %s\n", test.name, passed ? "passed" : "FAILED");
+        failures += !passed;
+    }
+    return failures;
+}
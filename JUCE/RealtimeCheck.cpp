@@ -0,0 +1,221 @@
+/*
+	Fails if the audio thread allocates, frees or takes a lock:
+
+		GaloisRealtimeCheck [--changes <count>]
+
+	malloc(), calloc(), realloc(), free(), pthread_mutex_lock() and
+	pthread_mutex_trylock() are replaced here with versions that count
+	calls from a thread marked as the audio thread, and pass them on to the
+	C library. So this builds on glibc only, and CMakeLists.txt adds the
+	GaloisRealtimeCheck target, and its CTest test, on Linux.
+
+	An audio thread runs processBlock() on float and double buffers at one,
+	two and six channels, and calls parameterChanged() itself every few
+	blocks the way host automation would. Meanwhile the main thread, which
+	is the message thread, makes --changes changes: it moves parameters,
+	switches factory presets and loads saved states with setCurrentProgram()
+	and setStateInformation().
+	Each of those rebuilds the snapshot there and then, so the audio thread
+	picks up new snapshots and tables as it goes. The message thread is
+	allowed to allocate and lock; the audio thread never is.
+
+	The processor runs in real time (setNonRealtime(false)) on purpose.
+	Offline, processBlock() calls timerCallback() itself, which rebuilds
+	the snapshot under snapshot_lock and may compile transfer tables
+	(processBlock -> timerCallback -> cacheWaveforms), so offline rendering
+	is excluded from the guarantee and from this check.
+
+	JUCE's own listener dispatch, which setValueNotifyingHost() goes
+	through, takes locks of its own, so the audio thread's automation
+	stores the raw parameter value and calls parameterChanged() directly.
+*/
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <atomic>
+#include <chrono>
+#include <dlfcn.h>
+#include <iostream>
+#include <pthread.h>
+#include <thread>
+
+//==============================================================================
+// The interposers
+
+static thread_local bool on_audio_thread = false;
+static std::atomic<int> audio_allocations { 0 };
+static std::atomic<int> audio_locks { 0 };
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* p, size_t size);
+extern "C" void __libc_free(void* p);
+
+typedef int (*MutexFunction)(pthread_mutex_t*);
+static MutexFunction real_mutex_lock = nullptr;
+static MutexFunction real_mutex_trylock = nullptr;
+
+extern "C" void* malloc(size_t size) {
+    if (on_audio_thread) {
+        ++audio_allocations;
+    }
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    if (on_audio_thread) {
+        ++audio_allocations;
+    }
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* p, size_t size) {
+    if (on_audio_thread) {
+        ++audio_allocations;
+    }
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void* p) {
+    if (on_audio_thread && p != nullptr) {
+        ++audio_allocations;
+    }
+    __libc_free(p);
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    if (on_audio_thread) {
+        ++audio_locks;
+    }
+    return real_mutex_lock(mutex);
+}
+
+extern "C" int pthread_mutex_trylock(pthread_mutex_t* mutex) {
+    if (on_audio_thread) {
+        ++audio_locks;
+    }
+    return real_mutex_trylock(mutex);
+}
+
+// Before anything locks a mutex, and before there is a second thread
+static struct LookUpMutexFunctions {
+    LookUpMutexFunctions() {
+        real_mutex_lock = (MutexFunction)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        real_mutex_trylock = (MutexFunction)dlsym(RTLD_NEXT, "pthread_mutex_trylock");
+    }
+} look_up_mutex_functions;
+
+//==============================================================================
+
+const double CHECK_SAMPLE_RATE = 48000;
+const int CHECK_BLOCK_SIZE = 256;
+
+// Automated from the audio thread: two that only set gains and coefficients, and one that recompiles the table
+const char* const AUDIO_THREAD_PARAMETERS[] = { "output_level", "biquad_cutoff", "wf_fold" };
+
+// Moved by the message thread: the waveform, the remapper's engines and the stages before and after it
+const char* const MESSAGE_THREAD_PARAMETERS[] = {
+    "wf_base_wave", "wf_power", "algorithm", "remap_engine", "oversampling", "antialiasing",
+    "math_accuracy", "wf_morph_mode", "wf_morph", "hold_units", "hold_rate", "filter_pre", "bit_depth"
+};
+const int NUM_MESSAGE_THREAD_PARAMETERS = sizeof(MESSAGE_THREAD_PARAMETERS) / sizeof(MESSAGE_THREAD_PARAMETERS[0]);
+
+/*
+    Runs the audio thread while the message thread makes the given number
+    of changes to the parameters, the preset and the state, and returns the
+    number of blocks the audio thread processed meanwhile.
+*/
+template <typename S>
+static int runAudioThread(Proto_galoisAudioProcessor& processor, int channels, int changes) {
+    std::atomic<bool> finished { false };
+    std::atomic<int> blocks { 0 };
+    juce::AudioBuffer<S> buffer(channels, CHECK_BLOCK_SIZE);
+    juce::MidiBuffer midi;
+    std::atomic<float>* automated[3];
+    for (int i = 0; i < 3; ++i) {
+        automated[i] = processor.tree.getRawParameterValue(AUDIO_THREAD_PARAMETERS[i]);
+    }
+    audio_allocations = 0;
+    audio_locks = 0;
+
+    std::thread audio([&]() {
+        on_audio_thread = true;
+        for (int b = 0; !finished.load(std::memory_order_acquire); ++b) {
+            for (int c = 0; c < channels; ++c) {
+                S* x = buffer.getWritePointer(c);
+                for (int i = 0; i < CHECK_BLOCK_SIZE; ++i) {
+                    x[i] = (S)(0.7 * sin(0.013 * (b * CHECK_BLOCK_SIZE + i) * (c % 2 + 1)));
+                }
+            }
+            if (b % 7 == 0) {
+                int p = (b / 7) % 3;
+                automated[p]->store(0.2f + 0.1f * (b % 5), std::memory_order_relaxed);
+                processor.parameterChanged(AUDIO_THREAD_PARAMETERS[p], automated[p]->load(std::memory_order_relaxed));
+            }
+            processor.processBlock(buffer, midi);
+            blocks.store(b + 1, std::memory_order_relaxed);
+        }
+        on_audio_thread = false;
+    });
+
+    juce::MemoryBlock saved;
+    processor.getStateInformation(saved);
+    for (int step = 0; step < changes; ++step) {
+        if (step % 5 == 0) {
+            processor.setCurrentProgram((step / 5) % NUM_FACTORY_PRESETS);
+        }
+        else if (step % 5 == 1) {
+            processor.setStateInformation(saved.getData(), (int)saved.getSize());
+        }
+        else {
+            const char* id = MESSAGE_THREAD_PARAMETERS[step % NUM_MESSAGE_THREAD_PARAMETERS];
+            juce::RangedAudioParameter* parameter = processor.tree.getParameter(id);
+            parameter->setValueNotifyingHost((float)((step * 37) % 101) / 100);
+        }
+        // Leaves the audio thread a block or two to pick the change up in
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    finished.store(true, std::memory_order_release);
+    audio.join();
+    return blocks;
+}
+
+int main(int argc, char* argv[]) {
+    int changes = 200;
+    for (int i = 1; i < argc; ++i) {
+        if (juce::String(argv[i]) == "--changes" && i + 1 < argc) {
+            changes = juce::String(argv[++i]).getIntValue();
+        }
+        else {
+            std::cerr << "usage: GaloisRealtimeCheck [--changes <count>]" << std::endl;
+            return 1;
+        }
+    }
+    juce::ScopedJuceInitialiser_GUI juce_initialiser;
+
+    int failures = 0;
+    for (int channels : { 1, 2, 6 }) {
+        for (bool use_double : { false, true }) {
+            Proto_galoisAudioProcessor processor;
+            if (use_double && !processor.supportsDoublePrecisionProcessing()) {
+                continue;
+            }
+            processor.setNonRealtime(false);
+            processor.setPlayConfigDetails(channels, channels, CHECK_SAMPLE_RATE, CHECK_BLOCK_SIZE);
+            processor.prepareToPlay(CHECK_SAMPLE_RATE, CHECK_BLOCK_SIZE);
+            // The factory presets are parsed on first use, which is the message thread's job
+            processor.setCurrentProgram(0);
+
+            int blocks = use_double ? runAudioThread<double>(processor, channels, changes)
+                                    : runAudioThread<float>(processor, channels, changes);
+            int allocations = audio_allocations;
+            int locks = audio_locks;
+            bool passed = allocations == 0 && locks == 0;
+            std::cout << channels << " channels, " << (use_double ? "double" : "float") << ", " << blocks << " blocks: "
+                      << allocations << " allocations, " << locks << " locks on the audio thread"
+                      << (passed ? "" : " FAILED") << std::endl;
+            failures += !passed;
+            processor.releaseResources();
+        }
+    }
+    return failures;
+}
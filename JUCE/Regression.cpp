@@ -0,0 +1,428 @@
+/*
+	Golden-output and throughput check over the factory presets:
+
+		GaloisRegression --record references
+		GaloisRegression --record-levels references
+		GaloisRegression --verify references [--max-slowdown 10]
+
+	Every preset renders the same seven seconds of stereo test signal: a
+	sine sweep, white noise, a synthetic drum loop and the sweep again
+	26 dB down. The sweeps are quieter on the right and the noise differs
+	between the channels, while the drums are the same in both, so that the
+	dual-mono path is covered too.
+
+	Each preset's levels, the RMS of each channel over each part of the
+	signal, go in the directory's manifest.xml. --record also writes each
+	preset's render and its time per sample there. --verify renders again
+	and fails if a preset's levels are further from the manifest's than its
+	level tolerance, if any sample is further from its recorded render than
+	its tolerance, or if the preset has slowed down by more than
+	--max-slowdown percent.
+
+	--record-levels writes the levels alone, which compare across machines
+	and compilers, unlike renders and times. regression/manifest.xml in the
+	repository is such a manifest, and CMakeLists.txt registers its
+	--verify with CTest. Record renders on a commit that is known to sound
+	right, and on the machine that will verify. Tolerances start at
+	--tolerance and --level-tolerance, and can be raised in manifest.xml for
+	a preset that needs the headroom, such as one on the fast math tier
+	when the compiler changes. Each render is timed --repeats times, each
+	with a fresh processor, and the best time is kept.
+
+	This is the GaloisRegression target in CMakeLists.txt, built like
+	BatchRender.cpp: with PluginProcessor.cpp, PluginEditor.cpp, galois_dsp
+	and the binary data, and with JucePlugin_Name defined.
+*/
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+const double REGRESSION_SAMPLE_RATE = 48000;
+const int REGRESSION_CHANNELS = 2;
+
+struct RegressionOptions {
+    bool record = false;
+    bool levels_only = false;       // Recording only the levels
+    juce::File directory;
+    int block_size = 512;
+    int repeats = 3;
+    double tolerance = 1e-5;
+    double level_tolerance = 1e-4;  // Of the RMS, which is at most the largest difference in a sample
+    double max_slowdown = 10;       // Percent
+};
+
+static void printUsage() {
+    std::cerr << "usage: GaloisRegression --record <directory> [--block <samples>] [--tolerance <difference>] [--level-tolerance <difference>] [--repeats <count>]" << std::endl
+              << "       GaloisRegression --record-levels <directory> [--block <samples>] [--level-tolerance <difference>]" << std::endl
+              << "       GaloisRegression --verify <directory> [--max-slowdown <percent>] [--repeats <count>]" << std::endl;
+}
+
+static bool parseArguments(int argc, char* argv[], RegressionOptions& options) {
+    juce::File cwd = juce::File::getCurrentWorkingDirectory();
+    bool has_mode = false;
+    for (int i = 1; i < argc; ++i) {
+        juce::String arg(argv[i]);
+        bool has_value = i + 1 < argc;
+        if ((arg == "--record" || arg == "--record-levels" || arg == "--verify") && has_value && !has_mode) {
+            options.record = arg != "--verify";
+            options.levels_only = arg == "--record-levels";
+            options.directory = cwd.getChildFile(argv[++i]);
+            has_mode = true;
+        }
+        else if (arg == "--block" && has_value) {
+            options.block_size = juce::String(argv[++i]).getIntValue();
+        }
+        else if (arg == "--repeats" && has_value) {
+            options.repeats = juce::String(argv[++i]).getIntValue();
+        }
+        else if (arg == "--tolerance" && has_value) {
+            options.tolerance = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (arg == "--level-tolerance" && has_value) {
+            options.level_tolerance = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (arg == "--max-slowdown" && has_value) {
+            options.max_slowdown = juce::String(argv[++i]).getDoubleValue();
+        }
+        else {
+            return false;
+        }
+    }
+    return has_mode && options.block_size > 0 && options.repeats > 0;
+}
+
+//==============================================================================
+// Test signals
+
+/*
+    The parts of the test signal, which the levels are measured over. The
+    signal is written here rather than taken from juce::Random, so that
+    levels recorded on one build compare with any other.
+*/
+struct Segment {
+    const char* name;
+    double seconds;
+};
+
+const Segment SEGMENTS[] = {
+    { "sweep", 2 },
+    { "noise", 1 },
+    { "drums", 2 },
+    { "quiet sweep", 2 },
+};
+const int NUM_SEGMENTS = sizeof(SEGMENTS) / sizeof(SEGMENTS[0]);
+
+// Uniform in [-1, 1), from a fixed seed
+class TestNoise
+{
+public:
+    explicit TestNoise(uint32_t seed) : state(seed) {}
+
+    float next() {
+        state = state * 1664525 + 1013904223;
+        return (float)(state >> 8) / (1 << 23) - 1;
+    }
+
+private:
+    uint32_t state;
+};
+
+// Two seconds of sine sweep from 20 Hz to 20 kHz, quieter on the right
+static void writeSweep(juce::AudioBuffer<float>& buffer, int start, double level) {
+    const int length = (int)(2 * REGRESSION_SAMPLE_RATE);
+    double phase = 0;
+    for (int i = 0; i < length; ++i) {
+        phase += 2 * M_PI * 20 * pow(1000.0, (double)i / length) / REGRESSION_SAMPLE_RATE;
+        buffer.setSample(0, start + i, (float)(0.8 * level * sin(phase)));
+        buffer.setSample(1, start + i, (float)(0.5 * level * sin(phase)));
+    }
+}
+
+// One second of white noise, different in each channel
+static void writeNoise(juce::AudioBuffer<float>& buffer, int start) {
+    const int length = (int)REGRESSION_SAMPLE_RATE;
+    TestNoise noise(1);
+    for (int c = 0; c < REGRESSION_CHANNELS; ++c) {
+        for (int i = 0; i < length; ++i) {
+            buffer.setSample(c, start + i, 0.5f * noise.next());
+        }
+    }
+}
+
+// Two seconds of drums at 120 bpm, the same in both channels: a kick on
+// the first and third beats, a snare on the second and fourth, and a hat on
+// every eighth note, with silence between the hits
+static void writeDrums(juce::AudioBuffer<float>& buffer, int start) {
+    const int length = (int)(2 * REGRESSION_SAMPLE_RATE);
+    const int eighth = (int)(REGRESSION_SAMPLE_RATE / 4);
+    TestNoise random(2);
+    for (int i = 0; i < length; ++i) {
+        int step = i / eighth;
+        double t = (double)(i % eighth) / REGRESSION_SAMPLE_RATE;
+        double noise = random.next();
+        double x = 0.2 * noise * exp(-t / 0.01);
+        if (step % 4 == 0) {
+            double phase = 2 * M_PI * (45 * t + 0.9 * (1 - exp(-t / 0.03)));
+            x += 0.9 * sin(phase) * exp(-t / 0.15);
+        }
+        else if (step % 4 == 2) {
+            x += (0.4 * noise + 0.3 * sin(2 * M_PI * 180 * t)) * exp(-t / 0.08);
+        }
+        if (t > 0.3) {
+            x = 0;
+        }
+        for (int c = 0; c < REGRESSION_CHANNELS; ++c) {
+            buffer.setSample(c, start + i, (float)x);
+        }
+    }
+}
+
+static juce::AudioBuffer<float> makeTestSignal() {
+    const int second = (int)REGRESSION_SAMPLE_RATE;
+    juce::AudioBuffer<float> buffer(REGRESSION_CHANNELS, 7 * second);
+    writeSweep(buffer, 0, 1);
+    writeNoise(buffer, 2 * second);
+    writeDrums(buffer, 3 * second);
+    // 26 dB down, where the bit crusher and the folds behave differently
+    writeSweep(buffer, 5 * second, 0.05);
+    return buffer;
+}
+
+// The RMS of each channel over each segment, channel by channel
+static juce::Array<double> measureLevels(const juce::AudioBuffer<float>& output) {
+    juce::Array<double> levels;
+    for (int c = 0; c < output.getNumChannels(); ++c) {
+        int start = 0;
+        for (const Segment& segment : SEGMENTS) {
+            int length = (int)(segment.seconds * REGRESSION_SAMPLE_RATE);
+            const float* x = output.getReadPointer(c) + start;
+            double sum = 0;
+            for (int i = 0; i < length; ++i) {
+                sum += (double)x[i] * x[i];
+            }
+            levels.add(sqrt(sum / length));
+            start += length;
+        }
+    }
+    return levels;
+}
+
+static juce::String formatLevels(const juce::Array<double>& levels) {
+    juce::StringArray text;
+    for (double level : levels) {
+        text.add(juce::String(level, 7));
+    }
+    return text.joinIntoString(" ");
+}
+
+// The largest difference between the levels, or -1 if there are not as many, or a level is NaN
+static double compareLevels(const juce::Array<double>& levels, const juce::String& recorded) {
+    juce::StringArray text = juce::StringArray::fromTokens(recorded, " ", "");
+    if (text.size() != levels.size()) {
+        return -1;
+    }
+    double worst = 0;
+    for (int i = 0; i < levels.size(); ++i) {
+        double difference = fabs(levels[i] - text[i].getDoubleValue());
+        if (!(difference <= worst)) {
+            worst = difference == difference ? difference : INFINITY;
+        }
+    }
+    return worst;
+}
+
+//==============================================================================
+
+struct PresetRender {
+    juce::AudioBuffer<float> output;
+    double ns_per_sample = 0;       // Per channel
+};
+
+// The first render's output, and the best time of them all
+static PresetRender renderPreset(int program, const juce::AudioBuffer<float>& input, int block_size, int repeats) {
+    PresetRender render;
+    render.ns_per_sample = 1e300;
+    juce::AudioBuffer<float> buffer;
+    juce::AudioBuffer<float> block(REGRESSION_CHANNELS, block_size);
+    juce::MidiBuffer midi;
+    for (int r = 0; r < repeats; ++r) {
+        Proto_galoisAudioProcessor processor;
+        processor.setNonRealtime(true);
+        processor.setCurrentProgram(program);
+        processor.setPlayConfigDetails(REGRESSION_CHANNELS, REGRESSION_CHANNELS, REGRESSION_SAMPLE_RATE, block_size);
+        processor.prepareToPlay(REGRESSION_SAMPLE_RATE, block_size);
+        buffer.makeCopyOf(input);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int position = 0; position < buffer.getNumSamples(); position += block_size) {
+            int n = juce::jmin(block_size, buffer.getNumSamples() - position);
+            block.setSize(REGRESSION_CHANNELS, n, false, false, true);
+            for (int c = 0; c < REGRESSION_CHANNELS; ++c) {
+                block.copyFrom(c, 0, buffer, c, position, n);
+            }
+            processor.processBlock(block, midi);
+            for (int c = 0; c < REGRESSION_CHANNELS; ++c) {
+                buffer.copyFrom(c, position, block, c, 0, n);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        render.ns_per_sample = juce::jmin(render.ns_per_sample, ns / ((double)buffer.getNumSamples() * REGRESSION_CHANNELS));
+        processor.releaseResources();
+        if (r == 0) {
+            render.output.makeCopyOf(buffer);
+        }
+    }
+    return render;
+}
+
+// References are raw native floats, one channel after the other
+static juce::File referenceFile(const juce::File& directory, int program) {
+    return directory.getChildFile("preset_" + juce::String(program) + ".f32");
+}
+
+static bool writeReference(const juce::File& file, const juce::AudioBuffer<float>& output) {
+    juce::MemoryBlock data;
+    for (int c = 0; c < output.getNumChannels(); ++c) {
+        data.append(output.getReadPointer(c), sizeof(float) * output.getNumSamples());
+    }
+    return file.replaceWithData(data.getData(), data.getSize());
+}
+
+// The largest difference between output and the reference, or -1 if the reference does not match its shape
+static double compareWithReference(const juce::File& file, const juce::AudioBuffer<float>& output) {
+    juce::MemoryBlock data;
+    const size_t channel_bytes = sizeof(float) * output.getNumSamples();
+    if (!file.loadFileAsData(data) || data.getSize() != channel_bytes * output.getNumChannels()) {
+        return -1;
+    }
+    double worst = 0;
+    for (int c = 0; c < output.getNumChannels(); ++c) {
+        const float* reference = (const float*)data.getData() + c * output.getNumSamples();
+        const float* x = output.getReadPointer(c);
+        for (int i = 0; i < output.getNumSamples(); ++i) {
+            double difference = fabs((double)x[i] - reference[i]);
+            // A NaN on either side is as far off as it gets
+            if (!(difference <= worst)) {
+                worst = difference == difference ? difference : INFINITY;
+            }
+        }
+    }
+    return worst;
+}
+
+//==============================================================================
+
+static int record(const RegressionOptions& options, const juce::AudioBuffer<float>& input) {
+    if (!options.directory.createDirectory()) {
+        std::cerr << "cannot create " << options.directory.getFullPathName() << std::endl;
+        return 1;
+    }
+    juce::XmlElement manifest("GaloisRegression");
+    manifest.setAttribute("block_size", options.block_size);
+    manifest.setAttribute("renders", options.levels_only ? 0 : 1);
+
+    Proto_galoisAudioProcessor names;
+    for (int program = 0; program < names.getNumPrograms(); ++program) {
+        PresetRender render = renderPreset(program, input, options.block_size, options.levels_only ? 1 : options.repeats);
+        juce::XmlElement* preset = manifest.createNewChildElement("Preset");
+        preset->setAttribute("program", program);
+        preset->setAttribute("name", names.getProgramName(program));
+        preset->setAttribute("level_tolerance", options.level_tolerance);
+        preset->setAttribute("levels", formatLevels(measureLevels(render.output)));
+        if (options.levels_only) {
+            std::cout << names.getProgramName(program) << std::endl;
+            continue;
+        }
+        if (!writeReference(referenceFile(options.directory, program), render.output)) {
+            std::cerr << "cannot write " << referenceFile(options.directory, program).getFullPathName() << std::endl;
+            return 1;
+        }
+        preset->setAttribute("tolerance", options.tolerance);
+        preset->setAttribute("ns_per_sample", render.ns_per_sample);
+        std::cout << names.getProgramName(program) << ": " << juce::String(render.ns_per_sample, 2) << " ns/sample" << std::endl;
+    }
+    if (!manifest.writeTo(options.directory.getChildFile("manifest.xml"))) {
+        std::cerr << "cannot write the manifest" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+static int verify(const RegressionOptions& options, const juce::AudioBuffer<float>& input) {
+    std::unique_ptr<juce::XmlElement> manifest = juce::XmlDocument::parse(options.directory.getChildFile("manifest.xml"));
+    if (manifest == nullptr || !manifest->hasTagName("GaloisRegression")) {
+        std::cerr << "no manifest in " << options.directory.getFullPathName() << std::endl;
+        return 1;
+    }
+    const int block_size = manifest->getIntAttribute("block_size", options.block_size);
+    const bool has_renders = manifest->getIntAttribute("renders", 1) != 0;
+
+    Proto_galoisAudioProcessor names;
+    int failures = 0;
+    int checked = 0;
+    for (auto* preset : manifest->getChildWithTagNameIterator("Preset")) {
+        int program = preset->getIntAttribute("program", -1);
+        juce::String name = preset->getStringAttribute("name");
+        if (program < 0 || program >= names.getNumPrograms() || names.getProgramName(program) != name) {
+            std::cout << "FAIL " << name << ": no longer a factory preset" << std::endl;
+            ++failures;
+            continue;
+        }
+        ++checked;
+        PresetRender render = renderPreset(program, input, block_size, options.repeats);
+
+        double level_tolerance = preset->getDoubleAttribute("level_tolerance", options.level_tolerance);
+        double level_difference = compareLevels(measureLevels(render.output), preset->getStringAttribute("levels"));
+        double tolerance = preset->getDoubleAttribute("tolerance", options.tolerance);
+        double difference = has_renders ? compareWithReference(referenceFile(options.directory, program), render.output) : 0;
+        double baseline = preset->getDoubleAttribute("ns_per_sample", 0);
+        double slowdown = baseline > 0 ? 100 * (render.ns_per_sample / baseline - 1) : 0;
+
+        juce::String problem;
+        if (level_difference < 0) {
+            problem = "missing or mismatched levels";
+        }
+        else if (level_difference > level_tolerance) {
+            problem = "levels differ by " + juce::String(level_difference, 8) + ", tolerance " + juce::String(level_tolerance, 8);
+        }
+        else if (difference < 0) {
+            problem = "missing or mismatched reference";
+        }
+        else if (difference > tolerance) {
+            problem = "output differs by " + juce::String(difference, 8) + ", tolerance " + juce::String(tolerance, 8);
+        }
+        else if (slowdown > options.max_slowdown) {
+            problem = juce::String(slowdown, 1) + "% slower, limit " + juce::String(options.max_slowdown, 1) + "%";
+        }
+        std::cout << (problem.isEmpty() ? "ok   " : "FAIL ") << name << ": "
+                  << juce::String(render.ns_per_sample, 2) << " ns/sample (" << (slowdown >= 0 ? "+" : "")
+                  << juce::String(slowdown, 1) << "%), levels within " << juce::String(juce::jmax(0.0, level_difference), 8);
+        if (has_renders) {
+            std::cout << ", max difference " << juce::String(juce::jmax(0.0, difference), 8);
+        }
+        if (problem.isNotEmpty()) {
+            std::cout << ": " << problem;
+            ++failures;
+        }
+        std::cout << std::endl;
+    }
+    if (checked < names.getNumPrograms()) {
+        std::cout << "FAIL " << names.getNumPrograms() - checked << " factory presets have no reference" << std::endl;
+        ++failures;
+    }
+    std::cout << (failures == 0 ? "passed" : "failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    RegressionOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    juce::ScopedJuceInitialiser_GUI juce_initialiser;
+    juce::AudioBuffer<float> input = makeTestSignal();
+    return options.record ? record(options, input) : verify(options, input);
+}
@@ -0,0 +1,119 @@
+/*
+	Fused remapping kernels. Each kernel is remap_sample() specialised at
+	compile time for one algorithm and one waveform, so the stage order and
+	the waveform call are resolved by the compiler and there is no dispatch
+	inside the block. The processor picks a kernel whenever the algorithm or
+	waveform parameter changes. There are NUM_ALGORITHMS * NUM_WFs of them,
+	which makes this the slowest part of the build.
+*/
+#pragma once
+#include "WaveformBlock.cpp"
+
+//=======================================
+// Stages
+//=======================================
+
+/*
+	Samples are processed in tiles of REMAP_TILE vectors. Running one sample
+	through all five stages makes a single long dependency chain, so each
+	stage instead runs across the whole tile, which keeps several independent
+	vectors in flight and the tile itself in registers. The mode tests depend
+	only on the StageConstants, so they are made once per stage per tile.
+*/
+const int REMAP_TILE = 8;
+
+template <int STAGE, int WF, typename M, typename T>
+inline void apply_stage_tile(const T* sample, T* val, const StageConstants& c) {
+	if constexpr (STAGE == ALGO_WF) {
+		for (int t = 0; t < REMAP_TILE; ++t) val[t] = waveform_v<WF, M>(val[t]);
+	}
+	else if constexpr (STAGE == ALGO_POWER) {
+		if (c.power_on) {
+			for (int t = 0; t < REMAP_TILE; ++t) val[t] = power_v<M>(val[t], c);
+		}
+	}
+	else if constexpr (STAGE == ALGO_HARMONICS) {
+		if (c.harm_mode != 0) {
+			for (int t = 0; t < REMAP_TILE; ++t) val[t] = harmonics_v<M>(sample[t], val[t], c);
+		}
+	}
+	else if constexpr (STAGE == ALGO_BIT) {
+		if (c.reduce_on) {
+			for (int t = 0; t < REMAP_TILE; ++t) val[t] = reduce_v<M>(val[t], c);
+		}
+		if (c.mask_mode > 0) {
+			for (int t = 0; t < REMAP_TILE; ++t) val[t] = mask_xor_v(val[t], c);
+		}
+		else if (c.mask_mode < 0) {
+			for (int t = 0; t < REMAP_TILE; ++t) val[t] = mask_and_v(val[t], c);
+		}
+	}
+	else {
+		if (c.fold_mode > 0) {
+			for (int t = 0; t < REMAP_TILE; ++t) val[t] = fold_mul_v<M>(val[t], c);
+		}
+		else if (c.fold_mode < 0) {
+			for (int t = 0; t < REMAP_TILE; ++t) val[t] = fold_sin_v<M>(val[t], c);
+		}
+	}
+	for (int t = 0; t < REMAP_TILE; ++t) val[t] = vm_clamp(val[t]);
+}
+
+// remap_sample() for one tile, with the stage order fixed at compile time
+template <int ALGO, int WF, typename M, typename T>
+inline void remap_tile(const T* sample, T* val, const StageConstants& c) {
+	for (int t = 0; t < REMAP_TILE; ++t) val[t] = sample[t];
+	apply_stage_tile<ALGORITHMS[ALGO][0], WF, M>(sample, val, c);
+	apply_stage_tile<ALGORITHMS[ALGO][1], WF, M>(sample, val, c);
+	apply_stage_tile<ALGORITHMS[ALGO][2], WF, M>(sample, val, c);
+	apply_stage_tile<ALGORITHMS[ALGO][3], WF, M>(sample, val, c);
+	apply_stage_tile<ALGORITHMS[ALGO][4], WF, M>(sample, val, c);
+	for (int t = 0; t < REMAP_TILE; ++t) {
+		val[t] = select(val[t] == val[t], val[t], T(0.0f));	// NaN check
+		val[t] = select(sample[t] == 0.0f, T(0.0f), val[t]);
+	}
+}
+
+//=======================================
+// Kernel table
+//=======================================
+
+typedef void (*RemapKernel)(const float* in, float* out, int n, const StageConstants& c);
+
+// in and out may be the same buffer
+template <int ALGO, int WF, typename M>
+void remap_kernel(const float* in, float* out, int n, const StageConstants& c) {
+	// A local copy, so the compiler knows the stores to out cannot change it
+	// and keeps the constants in registers
+	const StageConstants k = c;
+	vfloat sample[REMAP_TILE];
+	vfloat val[REMAP_TILE];
+	int i = 0;
+	for (; i + REMAP_TILE * VLANES <= n; i += REMAP_TILE * VLANES) {
+		for (int t = 0; t < REMAP_TILE; ++t) sample[t] = vload(in + i + t * VLANES);
+		remap_tile<ALGO, WF, M>(sample, val, k);
+		for (int t = 0; t < REMAP_TILE; ++t) vstore(out + i + t * VLANES, val[t]);
+	}
+	// The tail goes through the same tile, padded with silence
+	if (i < n) {
+		float padded[REMAP_TILE * VLANES] = {};
+		float result[REMAP_TILE * VLANES];
+		for (int j = i; j < n; ++j) padded[j - i] = in[j];
+		for (int t = 0; t < REMAP_TILE; ++t) sample[t] = vload(padded + t * VLANES);
+		remap_tile<ALGO, WF, M>(sample, val, k);
+		for (int t = 0; t < REMAP_TILE; ++t) vstore(result + t * VLANES, val[t]);
+		for (int j = i; j < n; ++j) out[j] = result[j - i];
+	}
+}
+// Indexed by algorithm * NUM_WFs + wf
+template <typename M, int... K>
+const RemapKernel* make_remap_kernels(std::integer_sequence<int, K...>) {
+	static const RemapKernel kernels[] = { remap_kernel<K / NUM_WFs, K % NUM_WFs, M>... };
+	return kernels;
+}
+
+template <typename M>
+RemapKernel get_remap_kernel(int algorithm, int wf) {
+	static const RemapKernel* kernels = make_remap_kernels<M>(std::make_integer_sequence<int, NUM_ALGORITHMS * NUM_WFs>());
+	return kernels[algorithm * NUM_WFs + wf];
+}
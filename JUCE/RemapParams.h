@@ -0,0 +1,72 @@
+#pragma once
+#include <cstring>
+#include <stdint.h>
+
+// Accuracy tiers for the math layer in FastMath.cpp
+enum {
+	MATH_EXACT,		// Standard library
+	MATH_PRECISE,	// Polynomial approximations, within 2e-7
+	MATH_FAST		// Lower order approximations, within 1.2e-4
+};
+
+/*
+	Everything remap_sample() depends on apart from the sample itself. Two sets
+	that compare equal always produce the same transfer curve.
+*/
+struct RemapParams {
+	int wf = 0;
+	float power = 0;
+	float harm_freq = 1;
+	float harm_amp = 0;
+	float bit_depth = 2;
+	float fold_amt = 0;
+	int mask = 0;
+	int algorithm = 0;		// Index into ALGORITHMS
+	int math_tier = MATH_PRECISE;	// Used by the block kernels; remap_sample() is always exact
+	bool morph = false;		// Compile every waveform into a bank; wf only picks the one displayed
+
+	bool operator==(const RemapParams& other) const {
+		return (morph ? other.morph : !other.morph && wf == other.wf)
+			&& power == other.power
+			&& harm_freq == other.harm_freq
+			&& harm_amp == other.harm_amp
+			&& bit_depth == other.bit_depth
+			&& fold_amt == other.fold_amt
+			&& mask == other.mask
+			&& algorithm == other.algorithm
+			&& math_tier == other.math_tier;
+	}
+
+	bool operator!=(const RemapParams& other) const {
+		return !(*this == other);
+	}
+
+	// Equal sets hash equally: wf is left out while morphing, and -0 hashes as 0
+	uint64_t hash() const {
+		uint64_t h = 14695981039346656037ull;	// FNV-1a
+		mix(h, morph ? -1 : wf);
+		mix(h, power);
+		mix(h, harm_freq);
+		mix(h, harm_amp);
+		mix(h, bit_depth);
+		mix(h, fold_amt);
+		mix(h, mask);
+		mix(h, algorithm);
+		mix(h, math_tier);
+		return h;
+	}
+
+private:
+	static void mix(uint64_t& h, int v) {
+		for (int i = 0; i < 4; ++i) {
+			h = (h ^ ((uint32_t)v >> (8 * i) & 0xff)) * 1099511628211ull;
+		}
+	}
+
+	static void mix(uint64_t& h, float v) {
+		int bits;
+		v = v == 0 ? 0 : v;
+		memcpy(&bits, &v, sizeof(bits));
+		mix(h, bits);
+	}
+};
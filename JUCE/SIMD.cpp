@@ -0,0 +1,314 @@
+/*
+	A minimal SIMD vector type for the block kernels.
+
+	vfloat holds VLANES floats (8 with AVX2, 4 with SSE2 or AArch64 NEON, 1
+	otherwise), vint the matching 32-bit integers and vmask the result of a
+	comparison. Every operation also has a plain float/int overload with the
+	same name, so kernels written as templates on the sample type compile
+	for both the vector body of a block and its scalar tail.
+
+	transpose() turns VLANES vectors of VLANES lanes around, so that lane
+	j of vector i trades places with lane i of vector j. It lets a kernel
+	work across channels, a channel to a lane, on samples loaded a channel
+	at a time.
+
+	Define GALOIS_NO_SIMD to build the scalar versions only.
+*/
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(GALOIS_NO_SIMD)
+	// Scalar only
+#elif defined(__AVX2__)
+	#define GALOIS_SIMD_AVX2 1
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define GALOIS_SIMD_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define GALOIS_SIMD_NEON 1
+	#include <arm_neon.h>
+#endif
+
+//=======================================
+// Scalar versions
+//=======================================
+
+inline float select(bool m, float a, float b) { return m ? a : b; }
+inline double select(bool m, double a, double b) { return m ? a : b; }
+inline float vabs(float x) { return std::fabs(x); }
+inline double vabs(double x) { return std::fabs(x); }
+inline float vsqrt(float x) { return std::sqrt(x); }
+inline double vsqrt(double x) { return std::sqrt(x); }
+inline int32_t vtrunc(float x) { return (int32_t)x; }
+inline float vtofloat(int32_t x) { return (float)x; }
+
+inline float vint_as_float(int32_t x) {
+	float f;
+	std::memcpy(&f, &x, sizeof(f));
+	return f;
+}
+
+inline int32_t vfloat_as_int(float x) {
+	int32_t i;
+	std::memcpy(&i, &x, sizeof(i));
+	return i;
+}
+
+//=======================================
+// Vector versions
+//=======================================
+
+#if GALOIS_SIMD_AVX2
+
+const int VLANES = 8;
+
+struct vfloat {
+	__m256 v;
+	vfloat() {}
+	vfloat(__m256 x) : v(x) {}
+	vfloat(float x) : v(_mm256_set1_ps(x)) {}
+};
+
+struct vint {
+	__m256i v;
+	vint() {}
+	vint(__m256i x) : v(x) {}
+	vint(int32_t x) : v(_mm256_set1_epi32(x)) {}
+};
+
+struct vmask {
+	__m256 v;
+};
+
+inline vfloat vload(const float* p) { return _mm256_loadu_ps(p); }
+inline void vstore(float* p, vfloat x) { _mm256_storeu_ps(p, x.v); }
+
+inline vfloat operator+(vfloat a, vfloat b) { return _mm256_add_ps(a.v, b.v); }
+inline vfloat operator-(vfloat a, vfloat b) { return _mm256_sub_ps(a.v, b.v); }
+inline vfloat operator*(vfloat a, vfloat b) { return _mm256_mul_ps(a.v, b.v); }
+inline vfloat operator/(vfloat a, vfloat b) { return _mm256_div_ps(a.v, b.v); }
+inline vfloat operator-(vfloat a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+inline vmask operator>(vfloat a, vfloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+inline vmask operator<(vfloat a, vfloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline vmask operator>=(vfloat a, vfloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+inline vmask operator<=(vfloat a, vfloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+inline vmask operator==(vfloat a, vfloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+
+inline vfloat select(vmask m, vfloat a, vfloat b) { return _mm256_blendv_ps(b.v, a.v, m.v); }
+inline vfloat vabs(vfloat x) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x.v); }
+inline vfloat vsqrt(vfloat x) { return _mm256_sqrt_ps(x.v); }
+
+inline vint vtrunc(vfloat x) { return _mm256_cvttps_epi32(x.v); }
+inline vfloat vtofloat(vint x) { return _mm256_cvtepi32_ps(x.v); }
+inline vfloat vint_as_float(vint x) { return _mm256_castsi256_ps(x.v); }
+inline vint vfloat_as_int(vfloat x) { return _mm256_castps_si256(x.v); }
+
+inline vint operator+(vint a, vint b) { return _mm256_add_epi32(a.v, b.v); }
+inline vint operator-(vint a, vint b) { return _mm256_sub_epi32(a.v, b.v); }
+inline vint operator&(vint a, vint b) { return _mm256_and_si256(a.v, b.v); }
+inline vint operator|(vint a, vint b) { return _mm256_or_si256(a.v, b.v); }
+inline vint operator^(vint a, vint b) { return _mm256_xor_si256(a.v, b.v); }
+inline vint operator<<(vint a, int n) { return _mm256_sll_epi32(a.v, _mm_cvtsi32_si128(n)); }
+inline vint operator>>(vint a, int n) { return _mm256_sra_epi32(a.v, _mm_cvtsi32_si128(n)); }
+
+inline void transpose(vfloat* rows) {
+	__m256 t0 = _mm256_unpacklo_ps(rows[0].v, rows[1].v);
+	__m256 t1 = _mm256_unpackhi_ps(rows[0].v, rows[1].v);
+	__m256 t2 = _mm256_unpacklo_ps(rows[2].v, rows[3].v);
+	__m256 t3 = _mm256_unpackhi_ps(rows[2].v, rows[3].v);
+	__m256 t4 = _mm256_unpacklo_ps(rows[4].v, rows[5].v);
+	__m256 t5 = _mm256_unpackhi_ps(rows[4].v, rows[5].v);
+	__m256 t6 = _mm256_unpacklo_ps(rows[6].v, rows[7].v);
+	__m256 t7 = _mm256_unpackhi_ps(rows[6].v, rows[7].v);
+	__m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+	rows[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+	rows[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+	rows[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+	rows[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+	rows[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+	rows[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+	rows[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+	rows[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+#elif GALOIS_SIMD_SSE2
+
+const int VLANES = 4;
+
+struct vfloat {
+	__m128 v;
+	vfloat() {}
+	vfloat(__m128 x) : v(x) {}
+	vfloat(float x) : v(_mm_set1_ps(x)) {}
+};
+
+struct vint {
+	__m128i v;
+	vint() {}
+	vint(__m128i x) : v(x) {}
+	vint(int32_t x) : v(_mm_set1_epi32(x)) {}
+};
+
+struct vmask {
+	__m128 v;
+};
+
+inline vfloat vload(const float* p) { return _mm_loadu_ps(p); }
+inline void vstore(float* p, vfloat x) { _mm_storeu_ps(p, x.v); }
+
+inline vfloat operator+(vfloat a, vfloat b) { return _mm_add_ps(a.v, b.v); }
+inline vfloat operator-(vfloat a, vfloat b) { return _mm_sub_ps(a.v, b.v); }
+inline vfloat operator*(vfloat a, vfloat b) { return _mm_mul_ps(a.v, b.v); }
+inline vfloat operator/(vfloat a, vfloat b) { return _mm_div_ps(a.v, b.v); }
+inline vfloat operator-(vfloat a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+inline vmask operator>(vfloat a, vfloat b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+inline vmask operator<(vfloat a, vfloat b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline vmask operator>=(vfloat a, vfloat b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+inline vmask operator<=(vfloat a, vfloat b) { return { _mm_cmple_ps(a.v, b.v) }; }
+inline vmask operator==(vfloat a, vfloat b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+
+inline vfloat select(vmask m, vfloat a, vfloat b) {
+	return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v));
+}
+inline vfloat vabs(vfloat x) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), x.v); }
+inline vfloat vsqrt(vfloat x) { return _mm_sqrt_ps(x.v); }
+
+inline vint vtrunc(vfloat x) { return _mm_cvttps_epi32(x.v); }
+inline vfloat vtofloat(vint x) { return _mm_cvtepi32_ps(x.v); }
+inline vfloat vint_as_float(vint x) { return _mm_castsi128_ps(x.v); }
+inline vint vfloat_as_int(vfloat x) { return _mm_castps_si128(x.v); }
+
+inline vint operator+(vint a, vint b) { return _mm_add_epi32(a.v, b.v); }
+inline vint operator-(vint a, vint b) { return _mm_sub_epi32(a.v, b.v); }
+inline vint operator&(vint a, vint b) { return _mm_and_si128(a.v, b.v); }
+inline vint operator|(vint a, vint b) { return _mm_or_si128(a.v, b.v); }
+inline vint operator^(vint a, vint b) { return _mm_xor_si128(a.v, b.v); }
+inline vint operator<<(vint a, int n) { return _mm_sll_epi32(a.v, _mm_cvtsi32_si128(n)); }
+inline vint operator>>(vint a, int n) { return _mm_sra_epi32(a.v, _mm_cvtsi32_si128(n)); }
+
+inline void transpose(vfloat* rows) {
+	_MM_TRANSPOSE4_PS(rows[0].v, rows[1].v, rows[2].v, rows[3].v);
+}
+
+#elif GALOIS_SIMD_NEON
+
+const int VLANES = 4;
+
+struct vfloat {
+	float32x4_t v;
+	vfloat() {}
+	vfloat(float32x4_t x) : v(x) {}
+	vfloat(float x) : v(vdupq_n_f32(x)) {}
+};
+
+struct vint {
+	int32x4_t v;
+	vint() {}
+	vint(int32x4_t x) : v(x) {}
+	vint(int32_t x) : v(vdupq_n_s32(x)) {}
+};
+
+struct vmask {
+	uint32x4_t v;
+};
+
+inline vfloat vload(const float* p) { return vld1q_f32(p); }
+inline void vstore(float* p, vfloat x) { vst1q_f32(p, x.v); }
+
+inline vfloat operator+(vfloat a, vfloat b) { return vaddq_f32(a.v, b.v); }
+inline vfloat operator-(vfloat a, vfloat b) { return vsubq_f32(a.v, b.v); }
+inline vfloat operator*(vfloat a, vfloat b) { return vmulq_f32(a.v, b.v); }
+inline vfloat operator/(vfloat a, vfloat b) { return vdivq_f32(a.v, b.v); }
+inline vfloat operator-(vfloat a) { return vnegq_f32(a.v); }
+
+inline vmask operator>(vfloat a, vfloat b) { return { vcgtq_f32(a.v, b.v) }; }
+inline vmask operator<(vfloat a, vfloat b) { return { vcltq_f32(a.v, b.v) }; }
+inline vmask operator>=(vfloat a, vfloat b) { return { vcgeq_f32(a.v, b.v) }; }
+inline vmask operator<=(vfloat a, vfloat b) { return { vcleq_f32(a.v, b.v) }; }
+inline vmask operator==(vfloat a, vfloat b) { return { vceqq_f32(a.v, b.v) }; }
+
+inline vfloat select(vmask m, vfloat a, vfloat b) { return vbslq_f32(m.v, a.v, b.v); }
+inline vfloat vabs(vfloat x) { return vabsq_f32(x.v); }
+inline vfloat vsqrt(vfloat x) { return vsqrtq_f32(x.v); }
+
+inline vint vtrunc(vfloat x) { return vcvtq_s32_f32(x.v); }
+inline vfloat vtofloat(vint x) { return vcvtq_f32_s32(x.v); }
+inline vfloat vint_as_float(vint x) { return vreinterpretq_f32_s32(x.v); }
+inline vint vfloat_as_int(vfloat x) { return vreinterpretq_s32_f32(x.v); }
+
+inline vint operator+(vint a, vint b) { return vaddq_s32(a.v, b.v); }
+inline vint operator-(vint a, vint b) { return vsubq_s32(a.v, b.v); }
+inline vint operator&(vint a, vint b) { return vandq_s32(a.v, b.v); }
+inline vint operator|(vint a, vint b) { return vorrq_s32(a.v, b.v); }
+inline vint operator^(vint a, vint b) { return veorq_s32(a.v, b.v); }
+inline vint operator<<(vint a, int n) { return vshlq_s32(a.v, vdupq_n_s32(n)); }
+inline vint operator>>(vint a, int n) { return vshlq_s32(a.v, vdupq_n_s32(-n)); }
+
+inline void transpose(vfloat* rows) {
+	float32x4x2_t t01 = vtrnq_f32(rows[0].v, rows[1].v);
+	float32x4x2_t t23 = vtrnq_f32(rows[2].v, rows[3].v);
+	rows[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+	rows[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+	rows[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+	rows[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+#else
+
+#define GALOIS_SIMD_SCALAR 1
+const int VLANES = 1;
+typedef float vfloat;
+typedef int32_t vint;
+
+inline vfloat vload(const float* p) { return *p; }
+inline void vstore(float* p, vfloat x) { *p = x; }
+inline void transpose(vfloat*) {}
+
+#endif
+
+//=======================================
+// Block loops
+//=======================================
+
+/*
+	Apply op to every sample, VLANES at a time, finishing the block with the
+	scalar overloads. op is usually a generic lambda so that it is
+	instantiated for both vfloat and float.
+*/
+template <typename Op>
+inline void for_each_sample(const float* in, float* out, int n, Op op) {
+	int i = 0;
+	if (VLANES > 1) {
+		for (; i + VLANES <= n; i += VLANES) {
+			vstore(out + i, op(vload(in + i)));
+		}
+	}
+	for (; i < n; ++i) {
+		out[i] = op(in[i]);
+	}
+}
+
+template <typename Op>
+inline void for_each_sample(const float* a, const float* b, float* out, int n, Op op) {
+	int i = 0;
+	if (VLANES > 1) {
+		for (; i + VLANES <= n; i += VLANES) {
+			vstore(out + i, op(vload(a + i), vload(b + i)));
+		}
+	}
+	for (; i < n; ++i) {
+		out[i] = op(a[i], b[i]);
+	}
+}
@@ -0,0 +1,74 @@
+/*
+	A fixed set of slots shared between a writer and the audio thread without
+	locks or allocation. The writer fills a slot that the audio thread is not
+	reading and publishes it. The audio thread moves on to the published slot
+	when it chooses, and marks the slots it is still reading so that the
+	writer leaves them alone. Slots are reused rather than freed, so a slot is
+	only ever reclaimed once the audio thread has let go of it.
+
+	The published index and the mask of slots in use are packed into one
+	atomic int, so that each side updates both in a single compare-exchange.
+	There must only be one writer at a time, and N must exceed the number of
+	slots the audio thread keeps plus one for the published slot.
+*/
+#pragma once
+#include <atomic>
+
+template <typename T, int N>
+class SlotExchange
+{
+public:
+    T& operator[](int slot) {
+        return slots[slot];
+    }
+
+    const T& operator[](int slot) const {
+        return slots[slot];
+    }
+
+    // Writer: the most recently published slot
+    int getPublished() const {
+        return state.load(std::memory_order_acquire) >> N;
+    }
+
+    /*
+        Writer: a slot that is neither published nor in use. It stays free
+        while it is filled, because the audio thread only ever moves on to
+        the published slot.
+    */
+    int getFreeSlot() const {
+        int s = state.load(std::memory_order_acquire);
+        int busy = (s & IN_USE_MASK) | (1 << (s >> N));
+        int slot = 0;
+        while (busy & (1 << slot)) {
+            ++slot;
+        }
+        return slot;
+    }
+
+    // Writer: makes a filled slot the published one
+    void publish(int slot) {
+        int s = state.load(std::memory_order_relaxed);
+        while (!state.compare_exchange_weak(s, (slot << N) | (s & IN_USE_MASK),
+            std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Audio thread: moves on to the published slot and returns it. also_in_use
+    // stays marked as well, or pass -1 to keep only the published slot.
+    int acquire(int also_in_use) {
+        int keep = also_in_use >= 0 ? 1 << also_in_use : 0;
+        int s = state.load(std::memory_order_acquire);
+        int published;
+        do {
+            published = s >> N;
+        } while (!state.compare_exchange_weak(s, (published << N) | (1 << published) | keep,
+            std::memory_order_acq_rel, std::memory_order_acquire));
+        return published;
+    }
+
+private:
+    static const int IN_USE_MASK = (1 << N) - 1;
+    T slots[N];
+    std::atomic<int> state { 0 };
+};
@@ -0,0 +1,99 @@
+/*
+    The processor's parameters as plain values, and the binary state that
+    getStateInformation() writes. Needs nothing but the standard library,
+    so it is part of galois_dsp and state round trips can be checked
+    without JUCE; PresetBank.cpp adds the XML states and factory presets.
+
+    A ParameterValues holds a plain value for each parameter in
+    STATE_PARAMETER_IDS, and whether it is set. The binary state is, in
+    little-endian order:
+
+        uint32  STATE_MAGIC
+        uint32  STATE_VERSION
+        uint32  number of values
+        float   the values, in STATE_PARAMETER_IDS order
+
+    Parameters are only ever added to the end of STATE_PARAMETER_IDS, so a
+    state from an older version sets the first of them and leaves the rest,
+    and the values past the end of a newer version's state are skipped.
+*/
+#pragma once
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+const char* const STATE_TYPE = "Galois_Parameter_Tree";
+
+// In the order of the binary state. Only ever add to the end.
+const char* const STATE_PARAMETER_IDS[] = {
+    "bit_depth", "sample_rate", "hold_units", "hold_rate", "hold_step",
+    "output_level", "input_level", "wf_base_wave", "wf_morph_mode", "wf_morph",
+    "wf_power", "wf_fold", "wf_harm_freq", "wf_harm_amp", "dry_blend",
+    "dry_blend_mode", "bit_mask", "filter_blend", "filter_pre", "biquad_cutoff",
+    "biquad_q", "biquad_gain", "algorithm", "remap_engine", "oversampling",
+    "antialiasing", "math_accuracy", "curve_ramp"
+};
+const int NUM_STATE_PARAMETERS = sizeof(STATE_PARAMETER_IDS) / sizeof(STATE_PARAMETER_IDS[0]);
+
+const uint32_t STATE_MAGIC = 0x534c4147;    // "GALS"
+const uint32_t STATE_VERSION = 1;
+const int STATE_HEADER_BYTES = 12;
+
+struct ParameterValues {
+    float value[NUM_STATE_PARAMETERS] = {};
+    bool is_set[NUM_STATE_PARAMETERS] = {};
+};
+
+// The index of id in STATE_PARAMETER_IDS, or -1
+inline int findStateParameter(const char* id) {
+    for (int i = 0; i < NUM_STATE_PARAMETERS; ++i) {
+        if (strcmp(id, STATE_PARAMETER_IDS[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+inline void writeStateWord(std::vector<uint8_t>& data, uint32_t word) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        data.push_back((uint8_t)(word >> shift));
+    }
+}
+
+inline uint32_t readStateWord(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+// Every value is written, set or not
+inline void writeBinaryState(const ParameterValues& values, std::vector<uint8_t>& data) {
+    data.clear();
+    writeStateWord(data, STATE_MAGIC);
+    writeStateWord(data, STATE_VERSION);
+    writeStateWord(data, NUM_STATE_PARAMETERS);
+    for (int i = 0; i < NUM_STATE_PARAMETERS; ++i) {
+        uint32_t bits;
+        memcpy(&bits, &values.value[i], sizeof(bits));
+        writeStateWord(data, bits);
+    }
+}
+
+// False if data is not a binary state, such as the XML of an older session
+inline bool readBinaryState(const void* data, int size, ParameterValues& values) {
+    if (data == nullptr || size < STATE_HEADER_BYTES) {
+        return false;
+    }
+    const uint8_t* bytes = (const uint8_t*)data;
+    if (readStateWord(bytes) != STATE_MAGIC || readStateWord(bytes + 4) < 1) {
+        return false;
+    }
+    uint32_t count = readStateWord(bytes + 8);
+    if (count > (uint32_t)(size - STATE_HEADER_BYTES) / 4) {
+        return false;
+    }
+    for (int i = 0; i < (int)count && i < NUM_STATE_PARAMETERS; ++i) {
+        uint32_t bits = readStateWord(bytes + STATE_HEADER_BYTES + 4 * i);
+        memcpy(&values.value[i], &bits, sizeof(bits));
+        values.is_set[i] = true;
+    }
+    return true;
+}
@@ -0,0 +1,253 @@
+/*
+	A transfer table is the whole remapping chain sampled at evenly spaced
+	input values, so that the audio thread can replace remap_sample() with a
+	single interpolated lookup. The chain is memoryless, so the table only
+	has to be recompiled when one of the RemapParams changes.
+
+	With RemapParams::morph set, the table instead holds a bank of curves,
+	one for every waveform, and lookupMorph() interpolates between
+	neighbouring waveforms as well as between neighbouring samples.
+
+	The table also holds the first and second antiderivatives of the
+	interpolated curve, for antiderivative anti-aliasing (see Adaa.cpp).
+	They are exact for the piecewise linear curve that lookup() follows, and
+	kept in double precision because ADAA divides their differences by
+	small steps in the input.
+*/
+#pragma once
+#include "Waveform.h"
+#include "WaveformBlock.cpp"
+#include "FixedPoint.cpp"
+
+// Inputs reach the remapper after the input gain (up to 4 * sqrt(2)) and the
+// pre-filter, so the table covers a wider range than [-1, 1]. Anything
+// outside it falls back to remap_sample().
+const float TABLE_RANGE = 8;
+const int TABLE_POINTS_PER_UNIT = 2048;
+const int TABLE_SIZE = 2 * (int)TABLE_RANGE * TABLE_POINTS_PER_UNIT + 1;
+const float TABLE_SCALE = (float)TABLE_POINTS_PER_UNIT;
+
+class TransferTable
+{
+public:
+	TransferTable() {
+		// One extra point so that interpolation at the last index never reads past the end
+		values = new float[TABLE_SIZE + 1];
+		integral1 = new double[TABLE_SIZE + 1];
+		integral2 = new double[TABLE_SIZE + 1];
+		for (int i = 0; i <= TABLE_SIZE; ++i) {
+			values[i] = 0;
+			integral1[i] = 0;
+			integral2[i] = 0;
+		}
+#if GALOIS_FIXED_POINT
+		fixed_values = new q15[TABLE_SIZE + 1];
+		for (int i = 0; i <= TABLE_SIZE; ++i) {
+			fixed_values[i] = 0;
+		}
+#endif
+	}
+
+	~TransferTable() {
+		delete[] values;
+		delete[] integral1;
+		delete[] integral2;
+		delete[] bank;
+#if GALOIS_FIXED_POINT
+		delete[] fixed_values;
+#endif
+	}
+
+	void compile(const RemapParams& p) {
+		params = p;
+		nan_points = 0;
+		if (params.morph) {
+			// Only allocated once morphing is first used, as it is NUM_WFs times the size
+			if (bank == 0) {
+				bank = new float[NUM_WFs * (TABLE_SIZE + 1)];
+			}
+			RemapParams wf_params = params;
+			for (int wf = 0; wf < NUM_WFs; ++wf) {
+				wf_params.wf = wf;
+				compile_values(wf_params, bank + wf * (TABLE_SIZE + 1), nan_points);
+			}
+			const float* displayed = bank + params.wf * (TABLE_SIZE + 1);
+			for (int i = 0; i <= TABLE_SIZE; ++i) {
+				values[i] = displayed[i];
+			}
+		}
+		else {
+			compile_values(params, values, nan_points);
+		}
+
+		// Integrate the piecewise linear curve segment by segment
+		const double h = 1.0 / TABLE_SCALE;
+		integral1[0] = 0;
+		integral2[0] = 0;
+		for (int i = 0; i < TABLE_SIZE; ++i) {
+			double v = values[i];
+			double dv = values[i + 1] - values[i];
+			integral1[i + 1] = integral1[i] + h * (v + dv / 2);
+			integral2[i + 1] = integral2[i] + h * integral1[i] + h * h * (v / 2 + dv / 6);
+		}
+#if GALOIS_FIXED_POINT
+		for (int i = 0; i <= TABLE_SIZE; ++i) {
+			fixed_values[i] = to_q15(values[i]);
+		}
+#endif
+		compiled = true;
+	}
+
+	float lookup(float sample) const {
+		if (!inRange(sample)) {
+			return remap_sample(sample, params);
+		}
+		float pos = (sample + TABLE_RANGE) * TABLE_SCALE;
+		int i = (int)pos;
+		float frac = pos - i;
+		return values[i] + frac * (values[i + 1] - values[i]);
+	}
+
+#if GALOIS_FIXED_POINT
+	// lookup() for the integer engine. Inputs outside the table take the value at its edge.
+	q27 lookupFixed(q27 sample) const {
+		const int frac_bits = Q27_BITS - 11;	// TABLE_POINTS_PER_UNIT is 2^11
+		int64_t pos = (int64_t)sample + ((int64_t)TABLE_RANGE << Q27_BITS);
+		const int64_t last = (int64_t)(TABLE_SIZE - 1) << frac_bits;
+		pos = pos < 0 ? 0 : (pos > last ? last : pos);
+		int i = (int)(pos >> frac_bits);
+		int32_t frac = (int32_t)(pos & ((1 << frac_bits) - 1));
+		int32_t v = fixed_values[i];
+		int32_t dv = fixed_values[i + 1] - v;
+		// dv * frac is Q31, so this lands in Q27
+		return q15_to_q27(v) + (q27)(((int64_t)dv * frac) >> (Q15_BITS + frac_bits - Q27_BITS));
+	}
+#endif
+
+	// lookup() at a position between waveforms, from 0 to NUM_WFs - 1. Only for a morph table.
+	float lookupMorph(float sample, float morph) const {
+		int wf = (int)morph;
+		if (wf > NUM_WFs - 2) {
+			wf = NUM_WFs - 2;
+		}
+		float wf_frac = morph - wf;
+		float a, b;
+		if (inRange(sample)) {
+			float pos = (sample + TABLE_RANGE) * TABLE_SCALE;
+			int i = (int)pos;
+			float frac = pos - i;
+			const float* lower = bank + wf * (TABLE_SIZE + 1);
+			const float* upper = lower + TABLE_SIZE + 1;
+			a = lower[i] + frac * (lower[i + 1] - lower[i]);
+			b = upper[i] + frac * (upper[i + 1] - upper[i]);
+		}
+		else {
+			RemapParams wf_params = params;
+			wf_params.wf = wf;
+			a = remap_sample(sample, wf_params);
+			wf_params.wf = wf + 1;
+			b = remap_sample(sample, wf_params);
+		}
+		return a + wf_frac * (b - a);
+	}
+
+	static bool inRange(float sample) {
+		return abs(sample) < TABLE_RANGE;
+	}
+
+	// First antiderivative of lookup(). sample must be inRange().
+	double antiderivative1(float sample) const {
+		double pos = ((double)sample + TABLE_RANGE) * TABLE_SCALE;
+		int i = (int)pos;
+		double t = (pos - i) / TABLE_SCALE;
+		double v = values[i];
+		double dv = (values[i + 1] - values[i]) * TABLE_SCALE;
+		return integral1[i] + t * (v + t * dv / 2);
+	}
+
+	// Second antiderivative of lookup(). sample must be inRange().
+	double antiderivative2(float sample) const {
+		double pos = ((double)sample + TABLE_RANGE) * TABLE_SCALE;
+		int i = (int)pos;
+		double t = (pos - i) / TABLE_SCALE;
+		double v = values[i];
+		double dv = (values[i + 1] - values[i]) * TABLE_SCALE;
+		return integral2[i] + t * (integral1[i] + t * (v / 2 + t * dv / 6));
+	}
+
+	static float indexToSample(int i) {
+		return (float)(i - (TABLE_SIZE - 1) / 2) / TABLE_SCALE;
+	}
+
+	const RemapParams& getParams() const {
+		return params;
+	}
+
+	bool isCompiledFor(const RemapParams& p) const {
+		return compiled && params == p;
+	}
+
+	// Points, across the bank when morphing, where the chain gave NaN and the NaN check zeroed it
+	int getNanPoints() const {
+		return nan_points;
+	}
+
+	// Bytes held by the table's arrays
+	size_t getMemorySize() const {
+		size_t points = TABLE_SIZE + 1;
+		size_t size = points * (sizeof(float) + 2 * sizeof(double));
+		if (bank != 0) {
+			size += NUM_WFs * points * sizeof(float);
+		}
+#if GALOIS_FIXED_POINT
+		size += points * sizeof(q15);
+#endif
+		return size;
+	}
+
+private:
+	// Samples one curve into TABLE_SIZE + 1 values, counting its NaN points into nan_points
+	static void compile_values(const RemapParams& p, float* out, int& nan_points) {
+		switch (p.math_tier) {
+		case MATH_EXACT:
+			for (int i = 0; i < TABLE_SIZE; ++i) {
+				out[i] = remap_sample(indexToSample(i), p, &nan_points);
+			}
+			break;
+		case MATH_PRECISE:
+			compile_blocks<VecMath>(p, out, nan_points);
+			break;
+		default:
+			compile_blocks<FastMath>(p, out, nan_points);
+			break;
+		}
+		out[TABLE_SIZE] = out[TABLE_SIZE - 1];
+	}
+
+	template <typename M>
+	static void compile_blocks(const RemapParams& p, float* out, int& nan_points) {
+		const int block = 256;
+		float in[block];
+		for (int start = 0; start < TABLE_SIZE; start += block) {
+			int n = TABLE_SIZE - start < block ? TABLE_SIZE - start : block;
+			for (int i = 0; i < n; ++i) {
+				in[i] = indexToSample(start + i);
+			}
+			remap_block<M>(in, out + start, n, p, &nan_points);
+		}
+	}
+
+	float* values;
+	double* integral1;
+	double* integral2;
+	float* bank = 0;
+#if GALOIS_FIXED_POINT
+	q15* fixed_values;
+#endif
+	RemapParams params;
+	bool compiled = false;
+	int nan_points = 0;
+
+	TransferTable(const TransferTable&) = delete;
+	TransferTable& operator=(const TransferTable&) = delete;
+};
@@ -0,0 +1,171 @@
+/*
+	Compiled transfer tables, shared by every processor in the process.
+	Instances on the same preset compile its curve once between them, and
+	hold one copy of it. Tables are handed out as shared pointers to const,
+	so a table lives for as long as anyone holds it, and nobody can change
+	it once it is compiled.
+
+	Tables are found by RemapParams::hash(), and told apart by
+	RemapParams' operator== when two sets collide. The cache keeps
+	recently used tables that nobody holds for when they are asked for
+	again, such as when a preset is reloaded, and drops the least recently
+	used of them once its tables take up more than the memory budget.
+	Tables still held are never dropped, so the cache outgrows its budget
+	while more than that is in use.
+
+	get() may be called from any thread but the audio thread: it takes a
+	lock, compiles on a miss, and may free tables. A table that another
+	thread is compiling is waited for rather than compiled twice.
+*/
+#pragma once
+#include "TransferTable.cpp"
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Enough for a hundred or so plain tables, or a dozen morphing banks
+const size_t TRANSFER_TABLE_CACHE_BUDGET = 64 << 20;
+
+struct TransferTableCacheStats {
+	int tables = 0;				// Compiled and cached
+	int tables_in_use = 0;		// Held outside the cache as well
+	size_t bytes = 0;
+	int64_t hits = 0;
+	int64_t misses = 0;
+	int64_t evictions = 0;
+};
+
+class TransferTableCache
+{
+public:
+	// The one cache in the process
+	static TransferTableCache& getInstance() {
+		static TransferTableCache cache;
+		return cache;
+	}
+
+	// The table compiled for p, compiling it if no one has yet
+	std::shared_ptr<const TransferTable> get(const RemapParams& p) {
+		const uint64_t hash = p.hash();
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			auto found = find(hash, p);
+			if (found == lru.end()) {
+				break;
+			}
+			if (found->table != nullptr) {
+				lru.splice(lru.begin(), lru, found);
+				++hits;
+				return found->table;
+			}
+			// Another thread is compiling it
+			compiled.wait(lock);
+		}
+
+		// Hold the place while compiling, so that other threads wait for this table
+		lru.push_front({ hash, p, nullptr, 0 });
+		auto entry = lru.begin();
+		index.emplace(hash, entry);
+		++misses;
+		lock.unlock();
+
+		std::shared_ptr<TransferTable> table = std::make_shared<TransferTable>();
+		table->compile(p);
+
+		lock.lock();
+		entry->table = table;
+		entry->bytes = table->getMemorySize();
+		bytes += entry->bytes;
+		evict();
+		compiled.notify_all();
+		return table;
+	}
+
+	void setMemoryBudget(size_t budget_bytes) {
+		std::lock_guard<std::mutex> lock(mutex);
+		budget = budget_bytes;
+		evict();
+	}
+
+	// Drops every table that nobody holds
+	void clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		size_t budget_was = budget;
+		budget = 0;
+		evict();
+		budget = budget_was;
+	}
+
+	TransferTableCacheStats getStats() {
+		std::lock_guard<std::mutex> lock(mutex);
+		TransferTableCacheStats stats;
+		for (const Entry& entry : lru) {
+			if (entry.table != nullptr) {
+				stats.tables++;
+				stats.tables_in_use += entry.table.use_count() > 1;
+			}
+		}
+		stats.bytes = bytes;
+		stats.hits = hits;
+		stats.misses = misses;
+		stats.evictions = evictions;
+		return stats;
+	}
+
+private:
+	TransferTableCache() {}
+
+	struct Entry {
+		uint64_t hash;
+		RemapParams params;
+		std::shared_ptr<const TransferTable> table;	// Null while it is being compiled
+		size_t bytes;
+	};
+	typedef std::list<Entry>::iterator EntryRef;
+
+	EntryRef find(uint64_t hash, const RemapParams& p) {
+		auto range = index.equal_range(hash);
+		for (auto i = range.first; i != range.second; ++i) {
+			if (i->second->params == p) {
+				return i->second;
+			}
+		}
+		return lru.end();
+	}
+
+	// Drops the least recently used tables that nobody else holds until the rest fit the budget
+	void evict() {
+		auto entry = lru.end();
+		while (bytes > budget && entry != lru.begin()) {
+			--entry;
+			if (entry->table == nullptr || entry->table.use_count() > 1) {
+				continue;
+			}
+			auto range = index.equal_range(entry->hash);
+			for (auto i = range.first; i != range.second; ++i) {
+				if (i->second == entry) {
+					index.erase(i);
+					break;
+				}
+			}
+			bytes -= entry->bytes;
+			++evictions;
+			entry = lru.erase(entry);
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable compiled;
+	std::list<Entry> lru;		// Most recently used first
+	std::unordered_multimap<uint64_t, EntryRef> index;
+	size_t bytes = 0;
+	size_t budget = TRANSFER_TABLE_CACHE_BUDGET;
+	int64_t hits = 0;
+	int64_t misses = 0;
+	int64_t evictions = 0;
+
+	TransferTableCache(const TransferTableCache&) = delete;
+	TransferTableCache& operator=(const TransferTableCache&) = delete;
+};
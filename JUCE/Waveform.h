@@ -0,0 +1,116 @@
+/*
+	The waveform functions and remapping stages, compiled once in
+	Waveform.cpp as part of the galois_dsp library.
+*/
+#pragma once
+#include <cmath>
+#include "RemapParams.h"
+
+const float PI = 2 * acos(0.0);
+const float TWO_PI = 2 * PI;
+const float ROOT_2 = sqrt(2);
+const int MAX_BIT_DEPTH = 1024;
+const float MAX_BIT_DEPTH_F = (float)MAX_BIT_DEPTH;
+
+//=======================================
+// Utilities
+//=======================================
+
+float clamp(float val, float min, float max);
+int sgn(double v);
+float ease_side(float sample, float amount);
+float ease_centre(float sample, float amount);
+float scaler(float in, float out);
+float expando(float in, float out);
+float fold(float sample);
+
+//=======================================
+// Function Pointer list
+//=======================================
+
+const int NUM_WFs = 31;
+extern float (* const ptr[NUM_WFs]) (float sample);
+extern const char* wf_names[NUM_WFs];
+
+//=======================================
+// Waveform Calculation
+//=======================================
+
+float apply_power(float val, float power);
+float apply_harmonics(float sample, float val, float harm_freq, float harm_amp);
+float apply_bit_mangling(float val, float bit_depth, int mask);
+float apply_fold(float val, float fold_amt);
+
+enum {
+	ALGO_WF,
+	ALGO_POWER,
+	ALGO_HARMONICS,
+	ALGO_BIT,
+	ALGO_FOLD
+};
+
+//=======================================
+// Algorithms
+//=======================================
+
+/*
+	An algorithm is the order in which remap_sample() applies the five
+	stages. There is one for every permutation of the ALGO_ values, in
+	lexicographic order, so that the "algorithm" parameter indexes this table.
+*/
+const int NUM_ALGORITHMS = 120;
+
+struct AlgorithmTable {
+	int order[NUM_ALGORITHMS][5];
+
+	constexpr const int* operator[](int i) const {
+		return order[i];
+	}
+};
+
+constexpr AlgorithmTable generate_algorithms() {
+	AlgorithmTable table{};
+	int a[5] = { ALGO_WF, ALGO_POWER, ALGO_HARMONICS, ALGO_BIT, ALGO_FOLD };
+	for (int i = 0; i < NUM_ALGORITHMS; ++i) {
+		for (int j = 0; j < 5; ++j) {
+			table.order[i][j] = a[j];
+		}
+		// Step to the next permutation, as std::next_permutation does
+		int k = 3;
+		while (k >= 0 && a[k] >= a[k + 1]) {
+			--k;
+		}
+		if (k < 0) {
+			break;
+		}
+		int l = 4;
+		while (a[l] <= a[k]) {
+			--l;
+		}
+		int t = a[k]; a[k] = a[l]; a[l] = t;
+		for (int lo = k + 1, hi = 4; lo < hi; ++lo, --hi) {
+			t = a[lo]; a[lo] = a[hi]; a[hi] = t;
+		}
+	}
+	return table;
+}
+
+constexpr AlgorithmTable ALGORITHMS = generate_algorithms();
+
+/*
+	Runs sample through the five stages in the order algorithm gives, and
+	clamps after each. A NaN result comes out as 0, and is counted in
+	nan_points if it is given.
+*/
+float remap_sample(
+	float sample,
+	int wf,
+	float power,
+	float harm_freq, float harm_amp, float bit_depth,
+	float fold_amt,
+	int mask,
+	const int* algorithm,
+	int* nan_points = 0
+);
+
+float remap_sample(float sample, const RemapParams& p, int* nan_points = 0);
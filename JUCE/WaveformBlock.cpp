@@ -0,0 +1,434 @@
+/*
+	Block versions of the waveforms and remapping stages in Waveform.cpp.
+
+	Everything here is a template on the sample type T, which is either a
+	plain float or a SIMD vfloat (see SIMD.cpp), and is written without
+	data-dependent branches: conditions become select() calls so that all
+	lanes of a vector take the same path. The transcendental functions come
+	from a math policy, which sets the accuracy (see FastMath.cpp).
+	Parameters are constant across one call, so audio-rate automation is
+	handled by calling these on short sub-blocks.
+*/
+#pragma once
+#include "Waveform.h"
+#include "FastMath.cpp"
+#include <utility>
+
+//=======================================
+// Branch-free utilities
+//=======================================
+
+// Same as scaler(), rearranged so that small inputs keep their precision in float
+template <typename T> inline T scaler_v(T in, T out) {
+	T a = vabs(in);
+	T scale = select(a <= 0.5f, 2.0f * a, 2.0f - 2.0f * a);
+	return in + scale * out;
+}
+
+template <typename T> inline T expando_v(T in, T out) {
+	return in * vabs(out);
+}
+
+template <typename M, typename T> inline T fold_v(T sample) {
+	T a = vabs(sample);
+	a = select(a > 2.0f, a - M::floor(a - 1.0f), a);
+	a = select(a > 1.0f, 2.0f - a, a);
+	return vm_sgn(sample) * a * 0.95f;
+}
+
+//=======================================
+// Functions
+//=======================================
+
+template <typename M, typename T> inline T wv_identity(T sample) {
+	return sample;
+}
+
+template <typename M, typename T> inline T wv_cosine(T sample) {
+	return M::cos(3 * PI / 2 + sample * (PI / 2));
+}
+
+template <typename M, typename T> inline T wv_tanh(T sample) {
+	return M::tanh(sample * PI);
+}
+
+template <typename M, typename T> inline T wv_scoop(T sample) {
+	return scaler_v(sample, vabs(M::sin((1.5f * PI / 2) * (sample + 1.0f))) * 2.0f - 1.0f) * 0.85f;
+}
+
+template <typename M, typename T> inline T wv_asin(T sample) {
+	return (2 / PI) * M::asin(sample);
+}
+
+template <typename M, typename T> inline T wv_cosstep(T sample) {
+	return scaler_v(sample, M::cos(2.0f * sample) * 0.5f);
+}
+
+template <typename M, typename T> inline T wv_sinstep(T sample) {
+	return scaler_v(sample, M::sin(-2.0f * sample) * 0.5f);
+}
+
+template <typename M, typename T> inline T wv_sinfold(T sample) {
+	return fold_v<M>(scaler_v(sample, vabs(M::sin(4.0f * sample))));
+}
+
+template <typename M, typename T> inline T wv_bigcos(T sample) {
+	T a = M::cos(9.0f * sample * sample);
+	return fold_v<M>(scaler_v(sample, a));
+}
+
+template <typename M, typename T> inline T wv_shcos(T sample) {
+	T a = M::sinh(sample) + M::cos(9.0f * sample * sample);
+	return fold_v<M>(scaler_v(sample, a));
+}
+
+template <typename M, typename T> inline T wv_thcos(T sample) {
+	T a = M::cos(9.0f * sample * sample) - M::tanh(5.0f * sample);
+	return fold_v<M>(scaler_v(sample, a));
+}
+
+template <typename M, typename T> inline T wv_fm1(T sample) {
+	T a = 2.0f * M::cos(M::sin(4.0f * sample) + M::cos(2.0f * sample - 1.0f));
+	return fold_v<M>(scaler_v(sample, a));
+}
+
+template <typename M, typename T> inline T wv_xp_sin(T sample) {
+	T a = vabs(2.0f * M::sin(TWO_PI * sample)) - 1.0f;
+	return expando_v(sample, a);
+}
+
+template <typename M, typename T> inline T wv_xp_cos(T sample) {
+	T a = vabs(1.5f * M::cos(TWO_PI * sample)) - 1.0f;
+	return expando_v(sample, a);
+}
+
+template <typename M, typename T> inline T wv_xp_sin_cos(T sample) {
+	T c = M::cos(TWO_PI * sample);
+	T s = M::sin(c * c);
+	T a = vabs(s * s * s) * 1.6f;
+	return expando_v(sample, a);
+}
+
+template <typename M, typename T> inline T wv_quadscale(T sample) {
+	T a = scaler_v(sample, 2.0f * sample * sample + sample);
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_blancmange(T sample) {
+	T b = 2.0f - vabs(sample);
+	T c = -vabs(0.3f * sample);
+	T a = scaler_v(c, M::sin(c) + 0.5f * b * b) * 6.0f;
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_foldscale(T sample) {
+	T a = scaler_v(sample, sample);
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_xpandoscale(T sample) {
+	T a = expando_v(2.0f * sample, scaler_v(sample, sample));
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_archer1(T sample) {
+	T a = -scaler_v(-vabs(sample), sample) * vm_sgn(sample);
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_archer3(T sample) {
+	T s = 0.7f * sample + 0.2f;
+	T a = scaler_v(2.0f * s, 1.0f / M::cos(s));
+	return fold_v<M>(expando_v(sample, a));
+}
+
+template <typename M, typename T> inline T wv_biscaler1(T sample) {
+	T a = scaler_v(sample * sample * sample, scaler_v(sample, sample));
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_biscaler2(T sample) {
+	T a = scaler_v(-vabs(sample), scaler_v(sample, M::cos(sample)));
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_biscaler3(T sample) {
+	T a = expando_v(sample, M::cos(sample * TWO_PI));
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_rhizome(T sample) {
+	T a = scaler_v(vabs(sample), 2.5f * sample);
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_cadmium(T sample) {
+	T a = expando_v(sample, scaler_v(vabs(sample), 2.0f * sample / M::cos(sample + PI)));
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_flotilla(T sample) {
+	T a = scaler_v(sample, vabs(expando_v(sample + 2.0f, sample - 1.0f)));
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_cubic(T sample) {
+	T a = scaler_v(sample * sample * sample, sample);
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_cubicquad(T sample) {
+	T a = scaler_v(sample * sample * sample, 1.0f - sample * sample);
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_cubicratio1(T sample) {
+	T a = scaler_v(vabs(sample * sample * sample), 2.0f / (2.0f + sample * sample));
+	return fold_v<M>(a);
+}
+
+template <typename M, typename T> inline T wv_cubicratio2(T sample) {
+	T a = scaler_v(2.0f * vabs(sample * sample), sample * 0.25f) * 2.0f - 1.0f;
+	return fold_v<M>(expando_v(sample, a));
+}
+
+template <typename M, typename T> inline T wv_cubicratio4(T sample) {
+	T a = scaler_v(0.5f * sample, sample + 3.0f) - 0.5f;
+	return fold_v<M>(expando_v(sample, a));
+}
+
+// Waveform WF from ptr[], resolved at compile time
+template <int WF, typename M, typename T> inline T waveform_v(T sample) {
+	if constexpr (WF == 0) return wv_identity<M>(sample);
+	else if constexpr (WF == 1) return wv_cosine<M>(sample);
+	else if constexpr (WF == 2) return wv_tanh<M>(sample);
+	else if constexpr (WF == 3) return wv_asin<M>(sample);
+	else if constexpr (WF == 4) return wv_cosstep<M>(sample);
+	else if constexpr (WF == 5) return wv_sinstep<M>(sample);
+	else if constexpr (WF == 6) return wv_archer1<M>(sample);
+	else if constexpr (WF == 7) return wv_biscaler1<M>(sample);
+	else if constexpr (WF == 8) return wv_cubic<M>(sample);
+	else if constexpr (WF == 9) return wv_cubicquad<M>(sample);
+	else if constexpr (WF == 10) return wv_cadmium<M>(sample);
+	else if constexpr (WF == 11) return wv_biscaler3<M>(sample);
+	else if constexpr (WF == 12) return wv_sinfold<M>(sample);
+	else if constexpr (WF == 13) return wv_scoop<M>(sample);
+	else if constexpr (WF == 14) return wv_bigcos<M>(sample);
+	else if constexpr (WF == 15) return wv_shcos<M>(sample);
+	else if constexpr (WF == 16) return wv_thcos<M>(sample);
+	else if constexpr (WF == 17) return wv_xp_sin<M>(sample);
+	else if constexpr (WF == 18) return wv_xp_cos<M>(sample);
+	else if constexpr (WF == 19) return wv_xp_sin_cos<M>(sample);
+	else if constexpr (WF == 20) return wv_quadscale<M>(sample);
+	else if constexpr (WF == 21) return wv_blancmange<M>(sample);
+	else if constexpr (WF == 22) return wv_foldscale<M>(sample);
+	else if constexpr (WF == 23) return wv_xpandoscale<M>(sample);
+	else if constexpr (WF == 24) return wv_archer3<M>(sample);
+	else if constexpr (WF == 25) return wv_biscaler2<M>(sample);
+	else if constexpr (WF == 26) return wv_rhizome<M>(sample);
+	else if constexpr (WF == 27) return wv_flotilla<M>(sample);
+	else if constexpr (WF == 28) return wv_cubicratio1<M>(sample);
+	else if constexpr (WF == 29) return wv_cubicratio2<M>(sample);
+	else return wv_cubicratio4<M>(sample);
+}
+static_assert(NUM_WFs == 31, "waveform_v() needs a case for every entry in ptr[]");
+
+//=======================================
+// Stages
+//=======================================
+
+/*
+	The stage parameters are turned into per-block constants once, so the
+	per-sample work below has no branches on the parameter values.
+*/
+struct StageConstants {
+	// apply_power
+	bool power_on;
+	float power;
+	// apply_harmonics
+	int harm_mode;			// 0 = off, 1 = positive amount, -1 = negative amount
+	float harm_amp;
+	float harm_freq;
+	// apply_bit_mangling
+	bool reduce_on;
+	float reduce_bd;
+	int mask_mode;			// 0 = off, 1 = xor, -1 = and
+	int mask;
+	// apply_fold
+	int fold_mode;			// 0 = off, 1 = multiply, -1 = sine
+	float fold_amt;
+
+	StageConstants(const RemapParams& p) {
+		power_on = p.power != 0;
+		power = -p.power;
+		power = power < 0 ? 1 + power : power * 10 + 1;
+
+		harm_mode = p.harm_amp > 0 ? 1 : (p.harm_amp < 0 ? -1 : 0);
+		harm_amp = abs(p.harm_amp) * 0.2f;
+		harm_freq = PI * p.harm_freq;
+
+		reduce_on = p.bit_depth > 2;
+		float bd = (MAX_BIT_DEPTH_F - abs(p.bit_depth) + 2) / MAX_BIT_DEPTH_F;
+		reduce_bd = bd * bd * bd * MAX_BIT_DEPTH_F;
+		mask_mode = p.mask > 0 ? 1 : (p.mask < 0 ? -1 : 0);
+		mask = p.mask > 0 ? p.mask : MAX_BIT_DEPTH - 1 + p.mask;
+
+		fold_mode = p.fold_amt > 0 ? 1 : (p.fold_amt < 0 ? -1 : 0);
+		fold_amt = p.fold_amt > 0 ? p.fold_amt + 1 : (p.fold_amt - 0.5f) * 3;
+	}
+};
+
+template <typename M, typename T> inline T power_v(T val, const StageConstants& c) {
+	return vm_sgn(val) * M::pow(vabs(val), c.power);
+}
+
+template <typename M, typename T> inline T harmonics_v(T sample, T val, const StageConstants& c) {
+	T a = c.harm_mode > 0 ? vabs(val) : 1.0f - vabs(val);
+	T amp = (1.0f - a * a) * c.harm_amp;
+	return val + M::sin(sample * c.harm_freq) * amp;
+}
+
+template <typename M, typename T> inline T reduce_v(T val, const StageConstants& c) {
+	return vm_sgn(val) * (M::floor(vabs(val) * c.reduce_bd) / c.reduce_bd);
+}
+
+template <typename T> inline T mask_xor_v(T val, const StageConstants& c) {
+	auto intval = vtrunc(vabs(val) * MAX_BIT_DEPTH_F);
+	return vm_sgn(val) * vtofloat(intval ^ c.mask) * (1 / MAX_BIT_DEPTH_F);
+}
+
+template <typename T> inline T mask_and_v(T val, const StageConstants& c) {
+	auto intval = vtrunc(vabs(val) * MAX_BIT_DEPTH_F);
+	return vm_sgn(val) * vtofloat(intval & c.mask) * (1 / MAX_BIT_DEPTH_F);
+}
+
+template <typename M, typename T> inline T fold_mul_v(T val, const StageConstants& c) {
+	return fold_v<M>(val * c.fold_amt);
+}
+
+template <typename M, typename T> inline T fold_sin_v(T val, const StageConstants& c) {
+	return fold_v<M>(M::sin(-val * c.fold_amt));
+}
+
+//=======================================
+// Block functions
+//=======================================
+
+typedef void (*BlockFunction)(const float* in, float* out, int n);
+
+/*
+	All block functions clamp their output to [-1, 1], as remap_sample() does
+	after every stage. in and out may be the same buffer.
+*/
+template <int WF, typename M>
+void waveform_block(const float* in, float* out, int n) {
+	for_each_sample(in, out, n, [](auto x) { return vm_clamp(waveform_v<WF, M>(x)); });
+}
+
+// Indexed like ptr[] in Waveform.cpp
+template <typename M, int... WF>
+const BlockFunction* make_waveform_blocks(std::integer_sequence<int, WF...>) {
+	static const BlockFunction blocks[] = { waveform_block<WF, M>... };
+	return blocks;
+}
+
+template <typename M>
+const BlockFunction* waveform_blocks() {
+	return make_waveform_blocks<M>(std::make_integer_sequence<int, NUM_WFs>());
+}
+
+template <typename M>
+void apply_power_block(const float* in, float* out, int n, const StageConstants& c) {
+	if (c.power_on) {
+		for_each_sample(in, out, n, [&](auto x) { return vm_clamp(power_v<M>(x, c)); });
+	}
+	else {
+		for_each_sample(in, out, n, [](auto x) { return vm_clamp(x); });
+	}
+}
+
+// sample holds the remapper's original input, which the harmonics are derived from
+template <typename M>
+void apply_harmonics_block(const float* sample, const float* in, float* out, int n, const StageConstants& c) {
+	if (c.harm_mode != 0) {
+		for_each_sample(sample, in, out, n, [&](auto s, auto x) { return vm_clamp(harmonics_v<M>(s, x, c)); });
+	}
+	else {
+		for_each_sample(in, out, n, [](auto x) { return vm_clamp(x); });
+	}
+}
+
+template <typename M>
+void apply_bit_mangling_block(const float* in, float* out, int n, const StageConstants& c) {
+	if (c.reduce_on) {
+		for_each_sample(in, out, n, [&](auto x) { return reduce_v<M>(x, c); });
+		in = out;
+	}
+	if (c.mask_mode > 0) {
+		for_each_sample(in, out, n, [&](auto x) { return vm_clamp(mask_xor_v(x, c)); });
+	}
+	else if (c.mask_mode < 0) {
+		for_each_sample(in, out, n, [&](auto x) { return vm_clamp(mask_and_v(x, c)); });
+	}
+	else {
+		for_each_sample(in, out, n, [](auto x) { return vm_clamp(x); });
+	}
+}
+
+template <typename M>
+void apply_fold_block(const float* in, float* out, int n, const StageConstants& c) {
+	if (c.fold_mode > 0) {
+		for_each_sample(in, out, n, [&](auto x) { return vm_clamp(fold_mul_v<M>(x, c)); });
+	}
+	else if (c.fold_mode < 0) {
+		for_each_sample(in, out, n, [&](auto x) { return vm_clamp(fold_sin_v<M>(x, c)); });
+	}
+	else {
+		for_each_sample(in, out, n, [](auto x) { return vm_clamp(x); });
+	}
+}
+
+/*
+	Block equivalent of remap_sample(). The chain runs stage by stage across
+	the whole block, so the algorithm switch happens five times per block
+	rather than five times per sample. in and out must not overlap. The
+	samples the NaN check zeroes are added to nan_points, if it is given.
+*/
+template <typename M>
+void remap_block(const float* in, float* out, int n, const RemapParams& p, int* nan_points = 0) {
+	StageConstants c(p);
+	const BlockFunction* waveforms = waveform_blocks<M>();
+	const int* algorithm = ALGORITHMS[p.algorithm];
+
+	for (int i = 0; i < n; ++i) {
+		out[i] = in[i];
+	}
+	for (int s = 0; s < 5; ++s) {
+		switch (algorithm[s]) {
+		case ALGO_WF:
+			waveforms[p.wf](out, out, n);
+			break;
+		case ALGO_POWER:
+			apply_power_block<M>(out, out, n, c);
+			break;
+		case ALGO_HARMONICS:
+			apply_harmonics_block<M>(in, out, out, n, c);
+			break;
+		case ALGO_BIT:
+			apply_bit_mangling_block<M>(out, out, n, c);
+			break;
+		case ALGO_FOLD:
+			apply_fold_block<M>(out, out, n, c);
+			break;
+		}
+	}
+	if (nan_points) {
+		for (int i = 0; i < n; ++i) {
+			*nan_points += out[i] != out[i] && in[i] != 0;
+		}
+	}
+	for_each_sample(in, out, out, n, [](auto s, auto val) {
+		val = select(val == val, val, decltype(val)(0.0f));	// NaN check
+		return select(s == 0.0f, decltype(val)(0.0f), val);
+	});
+}